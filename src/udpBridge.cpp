@@ -0,0 +1,176 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for bridging a node's GMII
+// interface to an external process
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cinttypes>
+
+#include "udpBridge.h"
+
+// --------------------------------------------------
+// Open the transport and take over received frames
+// --------------------------------------------------
+
+bool udpBridge::open (const char* name, uint32_t transport)
+{
+    if (!port.open(name, udpBridgePort::ROLE_SIM, transport))
+    {
+        printf("udpBridge::open() : ***ERROR. Failed to open bridge transport \"%s\"\n", name);
+        return false;
+    }
+
+    // Shared memory is cheap to poll, so check it every tick when idle
+    if (port.getTransport() == udpBridgePort::TRANSPORT_SHM)
+    {
+        poll_ticks                     = SHM_POLL_TICKS;
+    }
+
+    pVp->UdpVpRegisterRawRxCb(rxFrame, (void*)this);
+
+    return true;
+}
+
+// --------------------------------------------------
+// Close the transport
+// --------------------------------------------------
+
+void udpBridge::close (void)
+{
+    pVp->UdpVpRegisterRawRxCb(NULL, NULL);
+    port.close();
+}
+
+// --------------------------------------------------
+// Send the next frame from the external process,
+// else idle
+// --------------------------------------------------
+
+bool udpBridge::step (void)
+{
+    uint32_t len                       = port.recv(buf);
+
+    if (len == 0)
+    {
+        pVp->UdpVpSendIdle(poll_ticks);
+        return false;
+    }
+
+    uint32_t fidx                      = 0;
+
+#ifdef GENERATE_SOF_EOF
+    txframe[fidx++]                    = udpVProc::SOF;
+#endif
+
+    // Add the preamble and SFD, as for udpIpPg::ethFrame()
+    for (uint32_t idx = 0; idx < udpVProc::ETH_PREAMBLE-2; idx++)
+    {
+        txframe[fidx++]                = udpVProc::PREAMBLE;
+    }
+
+    txframe[fidx++]                    = udpVProc::SFD;
+
+    // Add the frame, padded to the minimum length, calculating the FCS on the way
+    const uint32_t* table              = udpVProc::UdpVpCrcTable();
+    uint32_t        crc                = udpVProc::INIT;
+
+    for (uint32_t idx = 0; idx < len || idx < MIN_FRAME_LEN; idx++)
+    {
+        uint32_t byte                  = idx < len ? buf[idx] : 0;
+
+        crc                            = table[(crc ^ byte) & 0xff] ^ (crc >> 8);
+        txframe[fidx++]                = byte;
+    }
+
+    crc                                ^= 0xffffffff;
+
+    for (uint32_t idx = 0; idx < udpVProc::ETH_CRC_LEN; idx++)
+    {
+        txframe[fidx++]                = (crc >> (8*idx)) & 0xff;
+    }
+
+#ifdef GENERATE_SOF_EOF
+    txframe[fidx++]                    = udpVProc::EoF;
+#endif
+
+    pVp->UdpVpSendRawEthFrame(txframe, fidx);
+    pVp->UdpVpSendIdle(IFG_TICKS - TX_GAP_TICKS);
+
+    stats.tx_frames++;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Run the bridge
+// --------------------------------------------------
+
+void udpBridge::run (uint32_t ticks)
+{
+    uint32_t start                     = pVp->UdpVpGetTicks();
+
+    while (ticks == RUN_FOREVER || (pVp->UdpVpGetTicks() - start) < ticks)
+    {
+        step();
+    }
+}
+
+// --------------------------------------------------
+// Pass a received frame, less its FCS, to the
+// external process
+// --------------------------------------------------
+
+void udpBridge::rxFrame (const uint32_t* frame, uint32_t len, void* hdl)
+{
+    udpBridge* p                       = (udpBridge*)hdl;
+    uint32_t   flen                    = len - udpVProc::ETH_CRC_LEN;
+
+    if (flen > udpBridgePort::MAX_FRAME_LEN)
+    {
+        p->stats.rx_dropped++;
+        return;
+    }
+
+    for (uint32_t idx = 0; idx < flen; idx++)
+    {
+        p->buf[idx]                    = frame[idx];
+    }
+
+    if (p->port.send(p->buf, flen))
+    {
+        p->stats.rx_frames++;
+    }
+    else
+    {
+        p->stats.rx_dropped++;
+    }
+}
+
+// --------------------------------------------------
+// Print the bridge statistics
+// --------------------------------------------------
+
+void udpBridge::printStats (int node)
+{
+    VPrint("Node%d: bridge %s: %" PRIu64 " frames sent, %" PRIu64 " frames received, %" PRIu64 " dropped\n",
+           node, port.getTransport() == udpBridgePort::TRANSPORT_SHM ? "shared memory" : "socket",
+           stats.tx_frames, stats.rx_frames, stats.rx_dropped);
+}
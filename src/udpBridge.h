@@ -0,0 +1,147 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for bridging a node's GMII interface to an
+// external process
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_BRIDGE_H_
+#define _UDP_BRIDGE_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "udpVProc.h"
+#include "udpBridgePort.h"
+
+// -------------------------------------------------------------
+// Bridge mode for a node. Frames from an external process
+// (see udpBridgePort) are sent on the node's GMII interface,
+// with preamble, SFD, padding and FCS added, and every frame
+// received with a good FCS is passed to the external process,
+// with the FCS removed, instead of to processFrame(). The node
+// then acts like a TAP interface onto the simulated network.
+//
+// run() idles the node whilst no frames are waiting, so that
+// reception continues, polling the transport every poll_ticks.
+// The minimum IFG is kept between sent frames. Frames that
+// cannot be passed on because the external process is not
+// keeping up, or is not connected, are dropped and counted.
+// -------------------------------------------------------------
+
+class udpBridge
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Minimum inter-frame gap (96 bits), and idle ticks already added after a
+    // frame by UdpVpSendRawEthFrame()
+    static const uint32_t IFG_TICKS            = 12;
+    static const uint32_t TX_GAP_TICKS         = 1;
+
+    // Minimum frame length, without FCS
+    static const uint32_t MIN_FRAME_LEN        = 60; // BYTES
+
+    // Default ticks between polls of the transport, when idle
+    static const uint32_t SHM_POLL_TICKS       = 1;
+    static const uint32_t SOCKET_POLL_TICKS    = 64;
+
+    // run() duration for no limit
+    static const uint32_t RUN_FOREVER          = 0xffffffff;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        uint64_t          tx_frames;     // Sent on GMII, from the external process
+        uint64_t          rx_frames;     // Received on GMII, passed to the external process
+        uint64_t          rx_dropped;    // Received on GMII, but not passed on
+    } bridgeStats_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpBridge (udpVProc* pVpIn) : pVp(pVpIn)
+    {
+        poll_ticks                     = SOCKET_POLL_TICKS;
+        stats                          = {0, 0, 0};
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to open the transport to the external process, and take over the
+    // node's received frames. Returns false on error.
+    bool           open                (const char* name, uint32_t transport = udpBridgePort::TRANSPORT_AUTO);
+
+    // Method to close the transport, and restore normal received frame processing
+    void           close               (void);
+
+    // Method to run the bridge for a number of ticks (or RUN_FOREVER)
+    void           run                 (uint32_t ticks = RUN_FOREVER);
+
+    // Method to send the next frame from the external process, if any, else
+    // idle for the poll interval. Returns true if a frame was sent.
+    bool           step                (void);
+
+    // Method to override the idle poll interval
+    void           setPollTicks        (uint32_t ticks) {poll_ticks = ticks ? ticks : 1;};
+
+    // Statistics access
+    bridgeStats_t& getStats            (void) {return stats;};
+    void           printStats          (int node);
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Raw received frame callback
+    static void    rxFrame             (const uint32_t* frame, uint32_t len, void* hdl);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node's VProc interface
+    udpVProc*      pVp;
+
+    // Transport to the external process
+    udpBridgePort  port;
+
+    // Idle ticks between transport polls
+    uint32_t       poll_ticks;
+
+    // Statistics
+    bridgeStats_t  stats;
+
+    // Frame buffers: bytes to/from the transport, and the frame to send on GMII
+    uint8_t        buf[udpBridgePort::MAX_FRAME_LEN];
+    uint32_t       txframe[udpBridgePort::MAX_FRAME_LEN + udpVProc::ETH_PREAMBLE + udpVProc::ETH_CRC_LEN + 2];
+};
+
+#endif
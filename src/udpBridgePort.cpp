@@ -0,0 +1,335 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for the frame transport between a
+// udpBridge and an external process
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <string.h>
+#include <errno.h>
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "udpBridgePort.h"
+
+// --------------------------------------------------
+// Open the transport
+// --------------------------------------------------
+
+bool udpBridgePort::open (const char* name, uint32_t roleIn, uint32_t transport)
+{
+    close();
+
+    if (strlen(name) > MAX_NAME_LEN)
+    {
+        printf("udpBridgePort::open() : ***ERROR. Name too long (%s)\n", name);
+        return false;
+    }
+
+    role                               = roleIn;
+    strcpy(name_buf, name);
+
+    if ((transport == TRANSPORT_SHM || transport == TRANSPORT_AUTO) && openShm())
+    {
+        trans                          = TRANSPORT_SHM;
+        return true;
+    }
+
+    if ((transport == TRANSPORT_SOCKET || transport == TRANSPORT_AUTO) && openSocket())
+    {
+        trans                          = TRANSPORT_SOCKET;
+        return true;
+    }
+
+    return false;
+}
+
+// --------------------------------------------------
+// Open the shared memory rings. The SIM role creates
+// and initialises the segment, and the PEER role
+// attaches to an initialised one.
+// --------------------------------------------------
+
+bool udpBridgePort::openShm (void)
+{
+    char shmname[160];
+    snprintf(shmname, sizeof(shmname), "/udpbridge_%s", name_buf);
+
+    int fd;
+
+    if (role == ROLE_SIM)
+    {
+        shm_unlink(shmname);
+        fd                             = shm_open(shmname, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+        if (fd >= 0 && ftruncate(fd, sizeof(shmLayout_t)) != 0)
+        {
+            ::close(fd);
+            shm_unlink(shmname);
+            fd                         = -1;
+        }
+    }
+    else
+    {
+        fd                             = shm_open(shmname, O_RDWR, 0);
+    }
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    void* mem                          = mmap(NULL, sizeof(shmLayout_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (mem == MAP_FAILED)
+    {
+        if (role == ROLE_SIM)
+        {
+            shm_unlink(shmname);
+        }
+        return false;
+    }
+
+    shm                                = (shmLayout_t*)mem;
+
+    if (role == ROLE_SIM)
+    {
+        // Construct the rings in place, then mark the segment as ready
+        new (&shm->to_sim)   frameRing_t();
+        new (&shm->from_sim) frameRing_t();
+
+        shm->version                   = SHM_VERSION;
+        shm->frame_len                 = MAX_FRAME_LEN;
+        shm->ring_entries              = RING_ENTRIES;
+        shm->magic.store(SHM_MAGIC, std::memory_order_release);
+
+        tx_ring                        = &shm->from_sim;
+        rx_ring                        = &shm->to_sim;
+    }
+    else
+    {
+        if (shm->magic.load(std::memory_order_acquire) != SHM_MAGIC || shm->version != SHM_VERSION ||
+            shm->frame_len != MAX_FRAME_LEN || shm->ring_entries != RING_ENTRIES)
+        {
+            munmap(shm, sizeof(shmLayout_t));
+            shm                        = NULL;
+            return false;
+        }
+
+        tx_ring                        = &shm->to_sim;
+        rx_ring                        = &shm->from_sim;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Open the socket. The SIM role listens, and the
+// PEER role connects.
+// --------------------------------------------------
+
+bool udpBridgePort::openSocket (void)
+{
+    struct sockaddr_un addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family                    = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "/tmp/udpbridge_%s.sock", name_buf);
+
+    int fd                             = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK, 0);
+
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    if (role == ROLE_SIM)
+    {
+        unlink(addr.sun_path);
+
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(fd, 1) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        listen_fd                      = fd;
+    }
+    else
+    {
+        if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        conn_fd                        = fd;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Accept a pending PEER connection (SIM role)
+// --------------------------------------------------
+
+void udpBridgePort::acceptPeer (void)
+{
+    if (listen_fd >= 0 && conn_fd < 0)
+    {
+        conn_fd                        = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK);
+    }
+}
+
+// --------------------------------------------------
+// Close the transport
+// --------------------------------------------------
+
+void udpBridgePort::close (void)
+{
+    if (shm != NULL)
+    {
+        munmap(shm, sizeof(shmLayout_t));
+        shm                            = NULL;
+        tx_ring                        = NULL;
+        rx_ring                        = NULL;
+
+        if (role == ROLE_SIM)
+        {
+            char shmname[160];
+            snprintf(shmname, sizeof(shmname), "/udpbridge_%s", name_buf);
+            shm_unlink(shmname);
+        }
+    }
+
+    if (conn_fd >= 0)
+    {
+        ::close(conn_fd);
+        conn_fd                        = -1;
+    }
+
+    if (listen_fd >= 0)
+    {
+        char path[160];
+        snprintf(path, sizeof(path), "/tmp/udpbridge_%s.sock", name_buf);
+
+        ::close(listen_fd);
+        unlink(path);
+        listen_fd                      = -1;
+    }
+
+    trans                              = TRANSPORT_NONE;
+}
+
+// --------------------------------------------------
+// Send a frame, without blocking
+// --------------------------------------------------
+
+bool udpBridgePort::send (const uint8_t* frame, uint32_t len)
+{
+    if (len > MAX_FRAME_LEN)
+    {
+        return false;
+    }
+
+    if (trans == TRANSPORT_SHM)
+    {
+        frameSlot_t* slot              = tx_ring->reserve();
+
+        if (slot == NULL)
+        {
+            return false;
+        }
+
+        memcpy(slot->data, frame, len);
+        slot->len                      = len;
+        tx_ring->commit();
+
+        return true;
+    }
+
+    acceptPeer();
+
+    if (conn_fd < 0)
+    {
+        return false;
+    }
+
+    if (::send(conn_fd, frame, len, MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t)len)
+    {
+        // Drop the connection if the other end has gone
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            ::close(conn_fd);
+            conn_fd                    = -1;
+        }
+        return false;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Receive a frame, if one is waiting, without
+// blocking
+// --------------------------------------------------
+
+uint32_t udpBridgePort::recv (uint8_t* buf)
+{
+    if (trans == TRANSPORT_SHM)
+    {
+        frameSlot_t* slot              = rx_ring->front();
+
+        if (slot == NULL)
+        {
+            return 0;
+        }
+
+        uint32_t len                   = slot->len <= MAX_FRAME_LEN ? slot->len : MAX_FRAME_LEN;
+        memcpy(buf, slot->data, len);
+        rx_ring->release();
+
+        return len;
+    }
+
+    acceptPeer();
+
+    if (conn_fd < 0)
+    {
+        return 0;
+    }
+
+    ssize_t len                        = ::recv(conn_fd, buf, MAX_FRAME_LEN, MSG_DONTWAIT);
+
+    // A zero length read is the other end closing the connection
+    if (len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+    {
+        ::close(conn_fd);
+        conn_fd                        = -1;
+    }
+
+    return len > 0 ? (uint32_t)len : 0;
+}
@@ -0,0 +1,182 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for the frame transport between a udpBridge
+// and an external process
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_BRIDGE_PORT_H_
+#define _UDP_BRIDGE_PORT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <atomic>
+
+#include "udpSpscRing.h"
+
+// -------------------------------------------------------------
+// One end of a frame transport between the simulation (the SIM
+// role, which owns the transport) and an external process (the
+// PEER role). Frames are Ethernet frames from the destination
+// address to the end of the payload, without preamble, SFD or
+// FCS, as seen on a TAP interface.
+//
+// The preferred transport is a POSIX shared memory segment,
+// /udpbridge_<name>, holding a lock-free SPSC ring in each
+// direction. The fallback is a Unix domain SOCK_SEQPACKET
+// socket, /tmp/udpbridge_<name>.sock, with the SIM role
+// listening for a single PEER connection. Neither send() nor
+// recv() ever blocks: a full transport drops the frame, and an
+// empty one returns no frame, so that the simulation is never
+// stalled by the external process.
+//
+// This class has no VProc dependency, so that it can be built
+// into external programs (see tools/udpBridgeTap.cpp).
+// -------------------------------------------------------------
+
+class udpBridgePort
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Roles
+    static const uint32_t ROLE_SIM             = 0;
+    static const uint32_t ROLE_PEER            = 1;
+
+    // Transports
+    static const uint32_t TRANSPORT_NONE       = 0;
+    static const uint32_t TRANSPORT_SHM        = 1;
+    static const uint32_t TRANSPORT_SOCKET     = 2;
+    static const uint32_t TRANSPORT_AUTO       = 3;  // Shared memory, falling back to a socket
+
+    // Largest frame (with an 802.1Q tag, without FCS), and ring size
+    static const uint32_t MAX_FRAME_LEN        = 1518; // BYTES
+    static const uint32_t RING_ENTRIES         = 256;
+
+    // Longest transport name
+    static const uint32_t MAX_NAME_LEN         = 64;
+
+    // Shared memory layout identification
+    static const uint32_t SHM_MAGIC            = 0x55425247; // "UBRG"
+    static const uint32_t SHM_VERSION          = 1;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // A frame ring slot
+    typedef struct {
+        uint32_t          len;
+        uint8_t           data[MAX_FRAME_LEN];
+    } frameSlot_t;
+
+    typedef udpSpscRing<frameSlot_t, RING_ENTRIES> frameRing_t;
+
+    // Shared memory segment layout. The magic number is set by the SIM role
+    // once the rings are initialised.
+    typedef struct {
+        std::atomic<uint32_t> magic;
+        uint32_t              version;
+        uint32_t              frame_len;
+        uint32_t              ring_entries;
+        frameRing_t           to_sim;
+        frameRing_t           from_sim;
+    } shmLayout_t;
+
+    // --------------------------------------------
+    // Constructor/destructor
+    // --------------------------------------------
+
+    udpBridgePort  ()
+    {
+        role                           = ROLE_SIM;
+        trans                          = TRANSPORT_NONE;
+        shm                            = NULL;
+        tx_ring                        = NULL;
+        rx_ring                        = NULL;
+        listen_fd                      = -1;
+        conn_fd                        = -1;
+        name_buf[0]                    = 0;
+    };
+
+    ~udpBridgePort () {close();};
+
+    udpBridgePort(const udpBridgePort&)            = delete;
+    udpBridgePort& operator=(const udpBridgePort&) = delete;
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to open the transport with the given name, in the given role. Returns false on error
+    // (for the PEER role, including when the SIM end is not yet open).
+    bool           open                (const char* name, uint32_t roleIn, uint32_t transport = TRANSPORT_AUTO);
+
+    // Method to close the transport, removing the shared memory or socket if the SIM role
+    void           close               (void);
+
+    // Method to send a frame. Returns false if not sent (transport full, not connected, or too big).
+    bool           send                (const uint8_t* frame, uint32_t len);
+
+    // Method to receive a frame into buf (of at least MAX_FRAME_LEN bytes). Returns the
+    // frame length, or 0 if none waiting.
+    uint32_t       recv                (uint8_t* buf);
+
+    // Status
+    uint32_t       getTransport        (void) {return trans;};
+    bool           connected           (void) {return trans == TRANSPORT_SHM || conn_fd >= 0;};
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    bool           openShm             (void);
+    bool           openSocket          (void);
+
+    // Method to accept a PEER socket connection, if one is pending
+    void           acceptPeer          (void);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Role and transport in use
+    uint32_t       role;
+    uint32_t       trans;
+
+    // Shared memory segment, and the rings for this end's TX and RX
+    shmLayout_t*   shm;
+    frameRing_t*   tx_ring;
+    frameRing_t*   rx_ring;
+
+    // Socket file descriptors
+    int            listen_fd;
+    int            conn_fd;
+
+    // Transport name
+    char           name_buf[MAX_NAME_LEN+1];
+};
+
+#endif
@@ -0,0 +1,339 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for seeded TX path fault injection
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cinttypes>
+
+#include "udpVProc.h"
+#include "udpFaultInject.h"
+
+// Fault names, indexed by fault type
+static const char* fault_names[udpFaultInject::NUM_FAULTS] = {
+    "FCS corruption",
+    "TX_ER assertion",
+    "truncated frame",
+    "short preamble",
+    "long preamble",
+    "runt frame",
+    "giant frame",
+    "IFG violation",
+    "IPv4 checksum corruption",
+    "UDP checksum corruption"
+};
+
+// --------------------------------------------------
+// Return a fault's name
+// --------------------------------------------------
+
+const char* udpFaultInject::faultName (uint32_t fault)
+{
+    return (fault < NUM_FAULTS) ? fault_names[fault] : "unknown";
+}
+
+// --------------------------------------------------
+// Set the generator seed. The seed is scrambled
+// (splitmix64) so that similar seeds give unrelated
+// sequences, and a zero state avoided.
+// --------------------------------------------------
+
+void udpFaultInject::setSeed (uint64_t seedIn)
+{
+    uint64_t z                         = seedIn + 0x9e3779b97f4a7c15ULL;
+    z                                  = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z                                  = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z                                  = z ^ (z >> 31);
+
+    state                              = z ? z : 1;
+}
+
+// --------------------------------------------------
+// Set a fault's per frame probability
+// --------------------------------------------------
+
+void udpFaultInject::setRate (uint32_t fault, double prob)
+{
+    if (fault >= NUM_FAULTS)
+    {
+        printf("NODE%d: udpFaultInject::setRate() : ***ERROR. Invalid fault type (%d)\n", node, fault);
+        return;
+    }
+
+    prob                               = (prob < 0.0) ? 0.0 : (prob > 1.0) ? 1.0 : prob;
+    threshold[fault]                   = (uint64_t)(prob * 4294967296.0);
+
+    enabled                            = false;
+    for (uint32_t idx = 0; idx < NUM_FAULTS; idx++)
+    {
+        enabled                        |= threshold[idx] != 0;
+    }
+}
+
+// --------------------------------------------------
+// Random number generation (xorshift64*)
+// --------------------------------------------------
+
+uint64_t udpFaultInject::rand64 (void)
+{
+    state                              ^= state >> 12;
+    state                              ^= state << 25;
+    state                              ^= state >> 27;
+
+    return state * 0x2545f4914f6cdd1dULL;
+}
+
+uint32_t udpFaultInject::randRange (uint32_t lo, uint32_t hi)
+{
+    return lo + (uint32_t)((rand64() >> 32) % (hi - lo + 1));
+}
+
+// --------------------------------------------------
+// Regenerate the FCS of a frame body (from the
+// destination address to the end of the FCS)
+// --------------------------------------------------
+
+void udpFaultInject::updateFcs (uint32_t* body, uint32_t body_len)
+{
+    const uint32_t* table              = udpVProc::UdpVpCrcTable();
+    uint32_t        crc                = udpVProc::INIT;
+
+    for (uint32_t idx = 0; idx < body_len - udpVProc::ETH_CRC_LEN; idx++)
+    {
+        crc                            = table[(crc ^ body[idx]) & 0xff] ^ (crc >> 8);
+    }
+
+    crc                                ^= 0xffffffff;
+
+    for (uint32_t idx = 0; idx < udpVProc::ETH_CRC_LEN; idx++)
+    {
+        body[body_len - udpVProc::ETH_CRC_LEN + idx] = (crc >> (8*idx)) & 0xff;
+    }
+}
+
+// --------------------------------------------------
+// Log an injected fault
+// --------------------------------------------------
+
+void udpFaultInject::logFault (uint32_t fault, uint32_t tick, uint32_t detail)
+{
+    count[fault]++;
+
+    UDP_LOG(node, tick, udpLog::LOG_INFO, "NODE%d: FAULT at tick %u: %s (%u)\n", node, tick, fault_names[fault], detail);
+}
+
+// --------------------------------------------------
+// Apply faults to a frame. Which faults fire is
+// decided up front, in a fixed order, so that the
+// random sequence depends only on the seed and the
+// number of frames sent.
+// --------------------------------------------------
+
+uint32_t* udpFaultInject::apply (uint32_t* frame, uint32_t &len, uint32_t tick, bool &no_ifg)
+{
+    no_ifg                             = false;
+
+    if (!enabled)
+    {
+        return frame;
+    }
+
+    bool fires[NUM_FAULTS];
+    bool any                           = false;
+
+    for (uint32_t idx = 0; idx < NUM_FAULTS; idx++)
+    {
+        fires[idx]                     = fire(idx);
+        any                            |= fires[idx];
+    }
+
+    if (!any)
+    {
+        return frame;
+    }
+
+    // Locate any SOF/EOF tokens, the preamble and the frame body
+    uint32_t sof                       = 0;
+    uint32_t eof                       = 0;
+
+#ifdef GENERATE_SOF_EOF
+    sof                                = (frame[0] == udpVProc::SOF) ? 1 : 0;
+    eof                                = (frame[len-1] == udpVProc::EoF) ? 1 : 0;
+#endif
+
+    uint32_t fidx                      = sof;
+    while (fidx < len && frame[fidx] == udpVProc::PREAMBLE)
+    {
+        fidx++;
+    }
+    uint32_t pre_len                   = fidx - sof;
+
+    uint32_t body_start                = (fidx < len && frame[fidx] == udpVProc::SFD) ? fidx + 1 : fidx;
+    uint32_t body_len                  = len - eof - body_start;
+
+    // Nothing to do on a frame without a body
+    if (len - eof <= body_start)
+    {
+        return frame;
+    }
+
+    // Construct faulted preamble
+    uint32_t bidx                      = 0;
+
+    if (sof)
+    {
+        buf[bidx++]                    = frame[0];
+    }
+
+    uint32_t new_pre_len               = pre_len;
+
+    if (fires[FAULT_SHORT_PREAMBLE] && pre_len)
+    {
+        new_pre_len                    = pre_len - randRange(1, pre_len);
+        logFault(FAULT_SHORT_PREAMBLE, tick, new_pre_len);
+    }
+    else if (fires[FAULT_LONG_PREAMBLE])
+    {
+        new_pre_len                    = pre_len + randRange(1, MAX_EXTRA_PREAMBLE);
+        logFault(FAULT_LONG_PREAMBLE, tick, new_pre_len);
+    }
+
+    for (uint32_t idx = 0; idx < new_pre_len; idx++)
+    {
+        buf[bidx++]                    = udpVProc::PREAMBLE;
+    }
+
+    if (body_start > sof + pre_len)
+    {
+        buf[bidx++]                    = udpVProc::SFD;
+    }
+
+    // Copy the frame body
+    uint32_t* body                     = &buf[bidx];
+
+    for (uint32_t idx = 0; idx < body_len; idx++)
+    {
+        body[idx]                      = frame[body_start + idx];
+    }
+
+    bool     is_ipv4                   = body_len > (udpVProc::ETH_HDR_LEN + 20) &&
+                                         body[12] == 0x08 && body[13] == 0x00;
+    bool     fcs_stale                 = false;
+
+    // Checksum corruption, with FCS regenerated
+    if (fires[FAULT_IPV4_CHKSUM] && is_ipv4)
+    {
+        uint32_t bit                   = randRange(0, 15);
+        body[udpVProc::ETH_HDR_LEN + 10 + bit/8] ^= 1 << (bit%8);
+        fcs_stale                      = true;
+        logFault(FAULT_IPV4_CHKSUM, tick, bit);
+    }
+
+    if (fires[FAULT_UDP_CHKSUM] && is_ipv4)
+    {
+        uint32_t offset                = udpVProc::ETH_HDR_LEN + (body[udpVProc::ETH_HDR_LEN] & 0xf)*4 + 6;
+
+        if (offset + 2 <= body_len - udpVProc::ETH_CRC_LEN)
+        {
+            uint32_t bit               = randRange(0, 15);
+            body[offset + bit/8]       ^= 1 << (bit%8);
+            fcs_stale                  = true;
+            logFault(FAULT_UDP_CHKSUM, tick, bit);
+        }
+    }
+
+    // Frame size faults, with FCS regenerated
+    uint32_t min_body                  = udpVProc::ETH_HDR_LEN + udpVProc::ETH_CRC_LEN;
+
+    if (fires[FAULT_RUNT] && body_len > min_body)
+    {
+        body_len                       = randRange(min_body, (body_len < 64 ? body_len : 64) - 1);
+        fcs_stale                      = true;
+        logFault(FAULT_RUNT, tick, body_len);
+    }
+    else if (fires[FAULT_GIANT])
+    {
+        uint32_t new_len               = randRange(1519, MAX_GIANT_LEN);
+
+        for (uint32_t idx = body_len - udpVProc::ETH_CRC_LEN; idx < new_len - udpVProc::ETH_CRC_LEN; idx++)
+        {
+            body[idx]                  = rand64() >> 56;
+        }
+
+        body_len                       = new_len;
+        fcs_stale                      = true;
+        logFault(FAULT_GIANT, tick, body_len);
+    }
+
+    if (fcs_stale)
+    {
+        updateFcs(body, body_len);
+    }
+
+    // Errors on the wire
+    if (fires[FAULT_FCS])
+    {
+        uint32_t bit                   = randRange(0, 31);
+        body[body_len - udpVProc::ETH_CRC_LEN + bit/8] ^= 1 << (bit%8);
+        logFault(FAULT_FCS, tick, bit);
+    }
+
+    if (fires[FAULT_TXER])
+    {
+        uint32_t idx                   = randRange(0, body_len-1);
+        body[idx]                      |= udpVProc::TX_ERROR_MASK;
+        logFault(FAULT_TXER, tick, idx);
+    }
+
+    if (fires[FAULT_TRUNCATE] && body_len > 1)
+    {
+        body_len                       = randRange(1, body_len-1);
+        logFault(FAULT_TRUNCATE, tick, body_len);
+    }
+
+    bidx                               += body_len;
+
+    if (eof)
+    {
+        buf[bidx++]                    = frame[len-1];
+    }
+
+    if (fires[FAULT_IFG])
+    {
+        no_ifg                         = true;
+        logFault(FAULT_IFG, tick, 0);
+    }
+
+    len                                = bidx;
+
+    return buf;
+}
+
+// --------------------------------------------------
+// Print counts of injected faults
+// --------------------------------------------------
+
+void udpFaultInject::printStats (void)
+{
+    for (uint32_t idx = 0; idx < NUM_FAULTS; idx++)
+    {
+        printf("NODE%d: %-26s: %" PRIu64 "\n", node, fault_names[idx], count[idx]);
+    }
+}
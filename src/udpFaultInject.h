@@ -0,0 +1,148 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for seeded TX path fault injection
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_FAULT_INJECT_H_
+#define _UDP_FAULT_INJECT_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------
+// Fault injection engine for frames sent with
+// udpVProc::UdpVpSendRawEthFrame(). Each fault type has a per
+// frame probability, and all random choices come from a single
+// seeded generator, so a run can be reproduced exactly from its
+// seed. Faults that corrupt a checksum, or change the frame size
+// (runt/giant), regenerate the FCS, so that only the intended
+// fault is seen by the receiver. Each fault injected is logged
+// with udpLog, at LOG_INFO.
+// -------------------------------------------------------------
+
+class udpFaultInject
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Fault types
+    static const uint32_t FAULT_FCS            = 0;  // Flip a bit in the FCS
+    static const uint32_t FAULT_TXER           = 1;  // Assert TX_ER on a byte
+    static const uint32_t FAULT_TRUNCATE       = 2;  // End frame early
+    static const uint32_t FAULT_SHORT_PREAMBLE = 3;  // Remove preamble bytes
+    static const uint32_t FAULT_LONG_PREAMBLE  = 4;  // Add preamble bytes
+    static const uint32_t FAULT_RUNT           = 5;  // Shorten below 64 bytes, with good FCS
+    static const uint32_t FAULT_GIANT          = 6;  // Lengthen beyond 1518 bytes, with good FCS
+    static const uint32_t FAULT_IFG            = 7;  // No inter-frame gap after frame
+    static const uint32_t FAULT_IPV4_CHKSUM    = 8;  // Flip a bit in IPv4 header checksum
+    static const uint32_t FAULT_UDP_CHKSUM     = 9;  // Flip a bit in UDP checksum
+    static const uint32_t NUM_FAULTS           = 10;
+
+    // Size of the faulted frame buffer (allowing for giant frames)
+    static const uint32_t MAX_FRAME_LEN        = 2048; // BYTES
+
+    // Giant frame and preamble size limits
+    static const uint32_t MAX_GIANT_LEN        = 2000; // BYTES, excluding preamble
+    static const uint32_t MAX_EXTRA_PREAMBLE   = 8;    // BYTES
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpFaultInject  (uint64_t seedIn = 1, int nodeIn = 0) : node(nodeIn)
+    {
+        setSeed(seedIn);
+
+        for (uint32_t idx = 0; idx < NUM_FAULTS; idx++)
+        {
+            threshold[idx]             = 0;
+            count[idx]                 = 0;
+        }
+
+        enabled                        = false;
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to set the generator seed
+    void           setSeed             (uint64_t seedIn);
+
+    // Method to set the per frame probability (0.0 to 1.0) of a fault type
+    void           setRate             (uint32_t fault, double prob);
+
+    // Method to apply faults to a frame about to be sent at tick. Returns a pointer to the
+    // frame to send (the original if no fault was injected), updating len, and sets no_ifg
+    // if the frame must be followed immediately by the next.
+    uint32_t*      apply               (uint32_t* frame, uint32_t &len, uint32_t tick, bool &no_ifg);
+
+    // Statistics
+    uint64_t       getCount            (uint32_t fault) {return (fault < NUM_FAULTS) ? count[fault] : 0;};
+    void           printStats          (void);
+
+    // Fault type name
+    static const char* faultName       (uint32_t fault);
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Random number generation (xorshift64*)
+    uint64_t       rand64              (void);
+    uint32_t       randRange           (uint32_t lo, uint32_t hi); // lo to hi inclusive
+
+    // Test whether a fault is to be injected on this frame
+    bool           fire                (uint32_t fault) {return threshold[fault] && (rand64() >> 32) < threshold[fault];};
+
+    // Regenerate the FCS over the frame body
+    void           updateFcs           (uint32_t* body, uint32_t body_len);
+
+    // Count and log (at udpLog::LOG_INFO) a fault
+    void           logFault            (uint32_t fault, uint32_t tick, uint32_t detail);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node number, for logging
+    int            node;
+
+    // Generator state
+    uint64_t       state;
+
+    // Per fault probability thresholds (as fraction of 2^32) and counts
+    uint64_t       threshold[NUM_FAULTS];
+    uint64_t       count[NUM_FAULTS];
+
+    // Set when any fault has a non-zero rate
+    bool           enabled;
+
+    // Buffer for faulted frame
+    uint32_t       buf[MAX_FRAME_LEN];
+};
+
+#endif
@@ -0,0 +1,440 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for bulk file transfer over UDP
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cinttypes>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "udpFileXfer.h"
+#include "udpShaper.h"
+
+// --------------------------------------------------
+// Send a file
+// --------------------------------------------------
+
+bool udpFileXfer::send (udpIpPg* pUdp, udpIpPg::udpConfig_t &dst, const char* fname, double rate, uint32_t chunk)
+{
+    if (chunk == 0 || chunk > MAX_CHUNK || rate <= 0.0 || rate > 100.0)
+    {
+        printf("udpFileXfer::send() : ***ERROR. Invalid chunk size (%d) or rate (%.3f%%)\n", chunk, rate);
+        return false;
+    }
+
+    int         fd;
+    struct stat st;
+
+    if ((fd = open(fname, O_RDONLY)) < 0 || fstat(fd, &st) < 0)
+    {
+        printf("udpFileXfer::send() : ***ERROR. Unable to open %s\n", fname);
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return false;
+    }
+
+    uint64_t       size                = st.st_size;
+    const uint8_t* base                = NULL;
+
+    if (size)
+    {
+        void* map                      = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (map == MAP_FAILED)
+        {
+            printf("udpFileXfer::send() : ***ERROR. Unable to map %s\n", fname);
+            close(fd);
+            return false;
+        }
+
+        base                           = (const uint8_t*)map;
+        madvise(map, size, MADV_SEQUENTIAL);
+    }
+
+    // An empty file is still sent as one (empty) chunk, so the receiver sees it
+    uint64_t num_chunks                = size ? (size + chunk - 1) / chunk : 1;
+    uint64_t page                      = sysconf(_SC_PAGESIZE);
+    uint64_t released                  = 0;
+    uint32_t crc                       = udpVProc::INIT;
+
+    uint32_t payload[HDR_LEN + MAX_CHUNK];
+    uint32_t frame[2048];
+
+    // Header fields fixed for the transfer
+    for (uint32_t idx = 0; idx < 4; idx++)
+    {
+        payload[idx]                   = (HDR_MAGIC          >> (24 - 8*idx)) & 0xff;
+        payload[8+idx]                 = ((size >> 32)       >> (24 - 8*idx)) & 0xff;
+        payload[12+idx]                = ((uint32_t)size     >> (24 - 8*idx)) & 0xff;
+        payload[16+idx]                = (chunk              >> (24 - 8*idx)) & 0xff;
+    }
+
+    udpShaper shaper(pUdp);
+    int       flow                     = -1;
+
+    tx_stats                           = {size, num_chunks, 0, 0, 0};
+
+    for (uint64_t seq = 0; seq < num_chunks; seq++)
+    {
+        uint64_t offset                = seq * chunk;
+        uint32_t len                   = (size - offset < chunk) ? (uint32_t)(size - offset) : chunk;
+
+        for (uint32_t idx = 0; idx < 4; idx++)
+        {
+            payload[4+idx]             = ((uint32_t)seq >> (24 - 8*idx)) & 0xff;
+        }
+
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            payload[HDR_LEN+idx]       = base[offset+idx];
+        }
+
+        crc                            = crc32(crc, base + offset, len);
+
+        uint32_t flen                  = pUdp->genUdpIpPkt(dst, frame, payload, HDR_LEN + len);
+
+        // Pace with a bucket of one (full size) frame, so there are no bursts
+        if (flow < 0 && (flow = shaper.addFlow(udpShaper::lineRate(rate), flen + udpShaper::IFG_TICKS)) < 0)
+        {
+            break;
+        }
+
+        uint32_t start                 = shaper.sendFrame(flow, frame, flen);
+
+        if (seq == 0)
+        {
+            tx_stats.start_tick        = start;
+        }
+
+        // Release the pages sent, a window at a time
+        uint64_t sent                  = ((offset + len) / page) * page;
+
+        if (sent - released >= RELEASE_BYTES)
+        {
+            madvise((void*)(base + released), sent - released, MADV_DONTNEED);
+            released                   = sent;
+        }
+    }
+
+    tx_stats.end_tick                  = pUdp->UdpVpGetTicks();
+    tx_stats.digest                    = crc ^ 0xffffffff;
+
+    if (size)
+    {
+        munmap((void*)base, size);
+    }
+    close(fd);
+
+    return flow >= 0;
+}
+
+// --------------------------------------------------
+// Start receiving a transfer
+// --------------------------------------------------
+
+bool udpFileXfer::startRx (const char* fname)
+{
+    std::lock_guard<std::mutex> guard(rx_lock);
+
+    if (rx_fp != NULL)
+    {
+        fclose(rx_fp);
+        rx_fp                          = NULL;
+    }
+
+    resetRx();
+
+    if (fname != NULL && (rx_fp = fopen(fname, "wb")) == NULL)
+    {
+        printf("udpFileXfer::startRx() : ***ERROR. Unable to open %s for writing\n", fname);
+        return false;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Reset the receive state
+// --------------------------------------------------
+
+void udpFileXfer::resetRx (void)
+{
+    rx_chunk                           = 0;
+    rx_num_chunks                      = 0;
+    rx_next                            = 0;
+    rx_crc                             = udpVProc::INIT;
+    rx_last_gap_end                    = UINT64_MAX;
+    rx_stats                           = {0, 0, 0, 0, 0, 0, 0, 0, 0, false};
+
+    rx_win.resize(REORDER_CHUNKS);
+    rx_win_valid.assign(REORDER_CHUNKS, false);
+    rx_gaps.clear();
+}
+
+// --------------------------------------------------
+// Process a received transfer datagram
+// --------------------------------------------------
+
+bool udpFileXfer::received (const uint8_t* payload, uint32_t len)
+{
+    if (!isXferPayload(payload, len))
+    {
+        return false;
+    }
+
+    uint64_t seq                       = getWord(payload, 4);
+    uint64_t size                      = ((uint64_t)getWord(payload, 8) << 32) | getWord(payload, 12);
+    uint32_t chunk                     = getWord(payload, 16);
+
+    std::lock_guard<std::mutex> guard(rx_lock);
+
+    // The first chunk received gives the transfer's dimensions
+    if (rx_chunk == 0 && chunk != 0 && chunk <= MAX_CHUNK)
+    {
+        rx_chunk                       = chunk;
+        rx_stats.file_size             = size;
+        rx_num_chunks                  = size ? (size + chunk - 1) / chunk : 1;
+    }
+
+    // Ignore datagrams not of this transfer, or inconsistent with it
+    if (rx_chunk == 0 || chunk != rx_chunk || size != rx_stats.file_size || seq >= rx_num_chunks ||
+        len - HDR_LEN != chunkLen(seq))
+    {
+        rx_stats.invalid++;
+        return true;
+    }
+
+    if (seq < rx_next)
+    {
+        rx_stats.late++;
+        return true;
+    }
+
+    // Move the window on, until it includes this chunk
+    while (seq >= rx_next + REORDER_CHUNKS)
+    {
+        advance();
+    }
+
+    uint32_t slot                      = seq % REORDER_CHUNKS;
+
+    if (rx_win_valid[slot])
+    {
+        rx_stats.duplicates++;
+        return true;
+    }
+
+    rx_stats.chunks++;
+
+    if (seq == rx_next)
+    {
+        consume(payload + HDR_LEN, len - HDR_LEN);
+        rx_next++;
+        drain();
+    }
+    else
+    {
+        rx_win[slot].assign(payload + HDR_LEN, payload + len);
+        rx_win_valid[slot]             = true;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Pass on the next chunk, or skip it as a gap if
+// it has not arrived
+// --------------------------------------------------
+
+void udpFileXfer::advance (void)
+{
+    uint32_t slot                      = rx_next % REORDER_CHUNKS;
+
+    if (rx_win_valid[slot])
+    {
+        consume(rx_win[slot].data(), rx_win[slot].size());
+        rx_win_valid[slot]             = false;
+    }
+    else
+    {
+        skip();
+    }
+
+    rx_next++;
+}
+
+// --------------------------------------------------
+// Pass on any held chunks following on in order
+// --------------------------------------------------
+
+void udpFileXfer::drain (void)
+{
+    while (rx_next < rx_num_chunks && rx_win_valid[rx_next % REORDER_CHUNKS])
+    {
+        advance();
+    }
+}
+
+// --------------------------------------------------
+// Pass the next chunk to the output and digest
+// --------------------------------------------------
+
+void udpFileXfer::consume (const uint8_t* data, uint32_t len)
+{
+    if (rx_fp != NULL && fwrite(data, 1, len, rx_fp) != len)
+    {
+        printf("udpFileXfer::consume() : ***ERROR. Write of received data failed\n");
+    }
+
+    rx_crc                             = crc32(rx_crc, data, len);
+    rx_stats.bytes                     += len;
+}
+
+// --------------------------------------------------
+// Skip the next chunk as missing, adding it to the
+// gaps
+// --------------------------------------------------
+
+void udpFileXfer::skip (void)
+{
+    if (rx_fp != NULL)
+    {
+        fseeko(rx_fp, chunkLen(rx_next), SEEK_CUR);
+    }
+
+    if (rx_next == rx_last_gap_end)
+    {
+        if (rx_stats.gaps <= MAX_GAPS_REPORTED)
+        {
+            rx_gaps.back().count++;
+        }
+    }
+    else
+    {
+        rx_stats.gaps++;
+
+        if (rx_stats.gaps <= MAX_GAPS_REPORTED)
+        {
+            rx_gaps.push_back({rx_next, 1});
+        }
+    }
+
+    rx_last_gap_end                    = rx_next + 1;
+    rx_stats.gap_chunks++;
+}
+
+// --------------------------------------------------
+// Complete the receive
+// --------------------------------------------------
+
+bool udpFileXfer::finishRx (void)
+{
+    std::lock_guard<std::mutex> guard(rx_lock);
+
+    while (rx_next < rx_num_chunks)
+    {
+        advance();
+    }
+
+    if (rx_fp != NULL)
+    {
+        // Extend the file over any gaps at its end
+        fflush(rx_fp);
+        if (ftruncate(fileno(rx_fp), rx_stats.file_size) < 0)
+        {
+            printf("udpFileXfer::finishRx() : ***ERROR. Unable to set the output file size\n");
+        }
+        fclose(rx_fp);
+        rx_fp                          = NULL;
+    }
+
+    rx_stats.digest                    = rx_crc ^ 0xffffffff;
+    rx_stats.complete                  = rx_chunk != 0 && rx_stats.gap_chunks == 0 && rx_stats.bytes == rx_stats.file_size;
+
+    return rx_stats.complete;
+}
+
+// --------------------------------------------------
+// Print a summary of the transfer
+// --------------------------------------------------
+
+void udpFileXfer::printStats (int node)
+{
+    if (tx_stats.chunks)
+    {
+        uint32_t ticks                 = tx_stats.end_tick - tx_stats.start_tick;
+
+        VPrint("Node%d: File transfer sent %" PRIu64 " bytes in %" PRIu64 " chunks over %u ticks (goodput %.3f%% of line rate), digest 0x%08x\n",
+               node, tx_stats.file_size, tx_stats.chunks, ticks,
+               ticks ? 100.0 * (double)tx_stats.file_size / (double)ticks : 0.0, tx_stats.digest);
+    }
+
+    std::lock_guard<std::mutex> guard(rx_lock);
+
+    if (rx_chunk == 0)
+    {
+        return;
+    }
+
+    VPrint("Node%d: File transfer received %" PRIu64 " of %" PRIu64 " bytes in %" PRIu64 " chunks, digest 0x%08x (%s)\n",
+           node, rx_stats.bytes, rx_stats.file_size, rx_stats.chunks, rx_stats.digest, rx_stats.complete ? "complete" : "INCOMPLETE");
+
+    if (rx_stats.duplicates || rx_stats.late || rx_stats.invalid)
+    {
+        VPrint("Node%d:   %" PRIu64 " duplicate, %" PRIu64 " late and %" PRIu64 " invalid chunks ignored\n",
+               node, rx_stats.duplicates, rx_stats.late, rx_stats.invalid);
+    }
+
+    if (rx_stats.gaps)
+    {
+        VPrint("Node%d:   %" PRIu64 " chunks missing, in %" PRIu64 " gaps%s\n",
+               node, rx_stats.gap_chunks, rx_stats.gaps, rx_stats.gaps > MAX_GAPS_REPORTED ? ", the first being" : ":");
+
+        for (uint32_t idx = 0; idx < rx_gaps.size(); idx++)
+        {
+            VPrint("Node%d:     chunks %" PRIu64 " to %" PRIu64 " (bytes %" PRIu64 " to %" PRIu64 ")\n",
+                   node, rx_gaps[idx].first, rx_gaps[idx].first + rx_gaps[idx].count - 1,
+                   rx_gaps[idx].first * rx_chunk, (rx_gaps[idx].first + rx_gaps[idx].count) * rx_chunk - 1);
+        }
+    }
+}
+
+// --------------------------------------------------
+// Update a running CRC32 (the Ethernet FCS
+// polynomial)
+// --------------------------------------------------
+
+uint32_t udpFileXfer::crc32 (uint32_t crc, const uint8_t* data, uint32_t len)
+{
+    const uint32_t* table              = udpVProc::UdpVpCrcTable();
+
+    for (uint32_t idx = 0; idx < len; idx++)
+    {
+        crc                            = table[(crc ^ data[idx]) & 0xff] ^ (crc >> 8);
+    }
+
+    return crc;
+}
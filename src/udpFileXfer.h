@@ -0,0 +1,206 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for bulk file transfer over UDP
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_FILE_XFER_H_
+#define _UDP_FILE_XFER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+#include "udpIpPg.h"
+
+// -------------------------------------------------------------
+// Bulk transfer of a file over UDP, for soak testing a DUT.
+// send() is called on the node sending into the DUT, and
+// received() from the receive callback of the node the DUT
+// forwards to, which may be on another thread.
+//
+// The sender memory maps the input file and sends it in
+// chunks, one per datagram, paced at a configured rate with a
+// udpShaper. Each datagram's payload starts with a header of
+// a magic number, the chunk's sequence number, the file size
+// and the chunk size (all big-endian). Pages already sent are
+// released as the transfer goes, so memory use does not grow
+// with the file size.
+//
+// The receiver writes the data in order to an output file,
+// and/or accumulates a CRC32 digest of it, to compare with the
+// sender's. Chunks arriving out of order are held in a window
+// of REORDER_CHUNKS. A chunk still missing when the window
+// moves past it, or at the end of the transfer, is a gap: its
+// bytes are skipped in the output file (left as a hole), and
+// are missing from the digest.
+// -------------------------------------------------------------
+
+class udpFileXfer
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Datagram header
+    static const uint32_t HDR_MAGIC            = 0x55465831; // "UFX1"
+    static const uint32_t HDR_LEN              = 20;         // BYTES
+
+    // Largest chunk, so that datagrams fit the Ethernet MTU (less the IPv4 and UDP headers)
+    static const uint32_t MAX_CHUNK            = udpVProc::ETH_MTU - 20 - 8 - HDR_LEN; // BYTES
+
+    // Receive reordering window, and the number of gaps reported individually
+    static const uint32_t REORDER_CHUNKS       = 64;
+    static const uint32_t MAX_GAPS_REPORTED    = 16;
+
+    // Sent file data is released from memory in windows of this size
+    static const uint64_t RELEASE_BYTES        = 64ULL << 20;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        uint64_t              file_size;
+        uint64_t              chunks;
+        uint32_t              start_tick;
+        uint32_t              end_tick;
+        uint32_t              digest;      // CRC32 of the file
+    } txStats_t;
+
+    // A range of missing chunks
+    typedef struct {
+        uint64_t              first;
+        uint64_t              count;
+    } gap_t;
+
+    typedef struct {
+        uint64_t              file_size;   // From the sender, once a chunk is received
+        uint64_t              bytes;       // Written to the output, and in the digest
+        uint64_t              chunks;
+        uint64_t              duplicates;  // Chunks already received
+        uint64_t              late;        // Chunks arriving after the window moved past them
+        uint64_t              invalid;     // Datagrams inconsistent with the transfer
+        uint64_t              gap_chunks;
+        uint64_t              gaps;        // Ranges of missing chunks
+        uint32_t              digest;      // CRC32 of the data received, in order
+        bool                  complete;    // All the file received, with no gaps
+    } rxStats_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpFileXfer ()
+    {
+        rx_fp                          = NULL;
+        tx_stats                       = {0, 0, 0, 0, 0};
+        resetRx();
+    };
+
+    ~udpFileXfer ()
+    {
+        if (rx_fp != NULL)
+        {
+            fclose(rx_fp);
+        }
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to send a file to the destination, at a rate (% of line rate), in chunks
+    // of up to MAX_CHUNK bytes. Returns false on error.
+    bool           send                (udpIpPg* pUdp, udpIpPg::udpConfig_t &dst, const char* fname,
+                                        double rate = 100.0, uint32_t chunk = MAX_CHUNK);
+
+    // Method to start receiving a transfer, writing to a file (if not NULL). Returns
+    // false on error.
+    bool           startRx             (const char* fname = NULL);
+
+    // Method, called by the receiving node, to process a received UDP payload. Returns
+    // true if it was a transfer datagram. May be called from another node's thread.
+    bool           received            (const uint8_t* payload, uint32_t len);
+
+    // Method to complete the receive, once the sender has finished and the DUT has
+    // drained, processing any held chunks and marking the rest as gaps. Returns true
+    // if the whole file was received.
+    bool           finishRx            (void);
+
+    // Method to test for a transfer datagram payload
+    static bool    isXferPayload       (const uint8_t* payload, uint32_t len) {return len >= HDR_LEN && getWord(payload, 0) == HDR_MAGIC;};
+
+    // Statistics access, and a summary, including any gaps
+    txStats_t&     getTxStats          (void) {return tx_stats;};
+    rxStats_t&     getRxStats          (void) {return rx_stats;};
+    void           printStats          (int node);
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to reset the receive state
+    void           resetRx             (void);
+
+    // Methods to pass the next chunk in order to the output, or to skip it as a gap
+    void           consume             (const uint8_t* data, uint32_t len);
+    void           skip                (void);
+
+    // Methods to move the window on by one chunk, and on past any held chunks
+    void           advance             (void);
+    void           drain               (void);
+
+    // Length of a chunk, given its sequence number
+    uint32_t       chunkLen            (uint64_t seq) {uint64_t off = seq * rx_chunk; return (rx_stats.file_size - off < rx_chunk) ? (uint32_t)(rx_stats.file_size - off) : rx_chunk;};
+
+    static uint32_t getWord            (const uint8_t* buf, uint32_t idx) {return ((uint32_t)buf[idx] << 24) | (buf[idx+1] << 16) | (buf[idx+2] << 8) | buf[idx+3];};
+
+    static uint32_t crc32              (uint32_t crc, const uint8_t* data, uint32_t len);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Sender statistics
+    txStats_t      tx_stats;
+
+    // Receive state: output file, chunk size and number of chunks (from the first
+    // chunk received), the next chunk to pass on, the reordering window, and the
+    // gaps reported (and the end of the last one)
+    std::mutex                         rx_lock;
+    FILE*                              rx_fp;
+    uint32_t                           rx_chunk;
+    uint64_t                           rx_num_chunks;
+    uint64_t                           rx_next;
+    uint32_t                           rx_crc;
+    std::vector<std::vector<uint8_t> > rx_win;
+    std::vector<bool>                  rx_win_valid;
+    std::vector<gap_t>                 rx_gaps;
+    uint64_t                           rx_last_gap_end;
+    rxStats_t                          rx_stats;
+};
+
+#endif
@@ -0,0 +1,336 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for UDP/IPv4 flow sweep generation
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include "udpFlowSweep.h"
+
+// --------------------------------------------------
+// Set a field's range of values
+// --------------------------------------------------
+
+bool udpFlowSweep::setRange (uint32_t field, uint32_t first, uint32_t count, uint32_t step)
+{
+    if (field >= NUM_FIELDS)
+    {
+        printf("udpFlowSweep::setRange() : ***ERROR. Invalid field (%d)\n", field);
+        return false;
+    }
+
+    if (field <= FIELD_DST_PORT && (first > 0xffff || count > 0x10000))
+    {
+        printf("udpFlowSweep::setRange() : ***ERROR. Port range (first %d, count %d) out of range\n", first, count);
+        return false;
+    }
+
+    ranges[field]                      = {first, count, step};
+    idx[field]                         = 0;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Build the base frame and patch in the values of
+// the first flow
+// --------------------------------------------------
+
+uint32_t udpFlowSweep::init (udpIpPg::udpConfig_t &cfg, uint32_t* payload, uint32_t payload_len)
+{
+    frame_len                          = pUdp->genUdpIpPkt(cfg, frame, payload, payload_len);
+    frames_gen                         = 0;
+
+    if (frame_len == 0)
+    {
+        printf("udpFlowSweep::init() : ***ERROR. Failed to generate base frame\n");
+        return 0;
+    }
+
+    // Locate the frame body, after any SOF token, the preamble and the SFD
+    body_start                         = 0;
+
+#ifdef GENERATE_SOF_EOF
+    body_start                         = (frame[0] == udpVProc::SOF) ? 1 : 0;
+#endif
+
+    while (body_start < frame_len && frame[body_start] == udpVProc::PREAMBLE)
+    {
+        body_start++;
+    }
+
+    body_start                         += (body_start < frame_len && frame[body_start] == udpVProc::SFD) ? 1 : 0;
+
+    // Pick up the base frame's field values
+    uint32_t* body                     = &frame[body_start];
+
+    cur[FIELD_SRC_PORT]                = (body[UDP_SRC_PORT_OFFSET] << 8) | body[UDP_SRC_PORT_OFFSET+1];
+    cur[FIELD_DST_PORT]                = (body[UDP_DST_PORT_OFFSET] << 8) | body[UDP_DST_PORT_OFFSET+1];
+    cur[FIELD_SRC_IP]                  = (body[IPV4_SRC_OFFSET]   << 24) | (body[IPV4_SRC_OFFSET+1] << 16) |
+                                         (body[IPV4_SRC_OFFSET+2] <<  8) |  body[IPV4_SRC_OFFSET+3];
+    cur[FIELD_DST_IP]                  = (body[IPV4_DST_OFFSET]   << 24) | (body[IPV4_DST_OFFSET+1] << 16) |
+                                         (body[IPV4_DST_OFFSET+2] <<  8) |  body[IPV4_DST_OFFSET+3];
+
+    udp_chksum_on                      = body[UDP_CHKSUM_OFFSET] != 0 || body[UDP_CHKSUM_OFFSET+1] != 0;
+    mac_dst_addr                       = cfg.mac_dst_addr;
+
+    // Set the first flow's values
+    for (uint32_t field = 0; field < NUM_FIELDS; field++)
+    {
+        idx[field]                     = 0;
+
+        if (ranges[field].count)
+        {
+            patchField(field, ranges[field].first);
+        }
+    }
+
+    updateFcs();
+
+    return frame_len;
+}
+
+// --------------------------------------------------
+// Return the frame for the next flow. The first
+// call after init() returns the first flow's frame.
+// --------------------------------------------------
+
+uint32_t* udpFlowSweep::next (uint32_t &len)
+{
+    if (frames_gen)
+    {
+        advance();
+        updateFcs();
+    }
+
+    frames_gen++;
+    len                                = frame_len;
+
+    return frame;
+}
+
+// --------------------------------------------------
+// Send a number of frames of the sweep
+// --------------------------------------------------
+
+uint64_t udpFlowSweep::send (uint64_t num_frames, uint32_t ifg_ticks)
+{
+    if (frame_len == 0)
+    {
+        printf("udpFlowSweep::send() : ***ERROR. No base frame (init() not called)\n");
+        return 0;
+    }
+
+    for (uint64_t fnum = 0; fnum < num_frames; fnum++)
+    {
+        uint32_t  len;
+        uint32_t* frm                  = next(len);
+
+        pUdp->UdpVpSendRawEthFrame(frm, len);
+
+        if (ifg_ticks)
+        {
+            pUdp->UdpVpSendIdle(ifg_ticks);
+        }
+    }
+
+    return num_frames;
+}
+
+// --------------------------------------------------
+// Number of distinct flows in the sweep
+// --------------------------------------------------
+
+uint64_t udpFlowSweep::numFlows (void)
+{
+    uint64_t flows                     = 1;
+
+    for (uint32_t field = 0; field < NUM_FIELDS; field++)
+    {
+        flows                          *= ranges[field].count ? ranges[field].count : 1;
+    }
+
+    return flows;
+}
+
+// --------------------------------------------------
+// RFC 1624 incremental checksum update:
+// HC' = ~(~HC + ~m + m')
+// --------------------------------------------------
+
+uint32_t udpFlowSweep::chksumUpdate (uint32_t hc, uint32_t m, uint32_t m_new)
+{
+    uint32_t sum                       = (~hc & 0xffff) + (~m & 0xffff) + (m_new & 0xffff);
+
+    sum                                = (sum & 0xffff) + (sum >> 16);
+    sum                                = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum & 0xffff;
+}
+
+// --------------------------------------------------
+// Choose the next set of field values, stepping the
+// odometer or picking at random, and patch any that
+// have changed into the frame
+// --------------------------------------------------
+
+void udpFlowSweep::advance (void)
+{
+    bool carry                         = true;
+
+    for (uint32_t field = 0; field < NUM_FIELDS; field++)
+    {
+        const fieldRange_t &r          = ranges[field];
+
+        if (r.count == 0)
+        {
+            continue;
+        }
+
+        if (random)
+        {
+            idx[field]                 = (uint32_t)((rand64() >> 32) % r.count);
+        }
+        else if (carry)
+        {
+            idx[field]                 = (idx[field] + 1 == r.count) ? 0 : idx[field] + 1;
+            carry                      = idx[field] == 0;
+        }
+
+        uint32_t val                   = r.first + idx[field] * r.step;
+        val                            &= (field <= FIELD_DST_PORT) ? 0xffff : 0xffffffff;
+
+        if (val != cur[field])
+        {
+            patchField(field, val);
+        }
+    }
+}
+
+// --------------------------------------------------
+// Write a field value into the frame, updating the
+// IPv4 header checksum (for addresses) and the UDP
+// checksum (which covers the addresses in its
+// pseudo-header) incrementally
+// --------------------------------------------------
+
+void udpFlowSweep::patchField (uint32_t field, uint32_t val)
+{
+    uint32_t* body                     = &frame[body_start];
+    bool      is_ip                    = field == FIELD_SRC_IP || field == FIELD_DST_IP;
+    uint32_t  offset                   = field == FIELD_SRC_PORT ? UDP_SRC_PORT_OFFSET :
+                                         field == FIELD_DST_PORT ? UDP_DST_PORT_OFFSET :
+                                         field == FIELD_SRC_IP   ? IPV4_SRC_OFFSET     :
+                                                                   IPV4_DST_OFFSET;
+    uint32_t  words                    = is_ip ? 2 : 1;
+
+    uint32_t  ip_hc                    = (body[IPV4_CHKSUM_OFFSET] << 8) | body[IPV4_CHKSUM_OFFSET+1];
+    uint32_t  udp_hc                   = (body[UDP_CHKSUM_OFFSET]  << 8) | body[UDP_CHKSUM_OFFSET+1];
+
+    for (uint32_t widx = 0; widx < words; widx++)
+    {
+        uint32_t shift                 = (words - 1 - widx) * 16;
+        uint32_t m                     = (cur[field] >> shift) & 0xffff;
+        uint32_t m_new                 = (val        >> shift) & 0xffff;
+
+        if (is_ip)
+        {
+            ip_hc                      = chksumUpdate(ip_hc, m, m_new);
+        }
+
+        if (udp_chksum_on)
+        {
+            udp_hc                     = chksumUpdate(udp_hc, m, m_new);
+        }
+
+        body[offset + widx*2]          = m_new >> 8;
+        body[offset + widx*2 + 1]      = m_new & 0xff;
+    }
+
+    if (is_ip)
+    {
+        body[IPV4_CHKSUM_OFFSET]       = ip_hc >> 8;
+        body[IPV4_CHKSUM_OFFSET+1]     = ip_hc & 0xff;
+    }
+
+    // A calculated UDP checksum of zero is sent as all ones, as zero means no checksum
+    if (udp_chksum_on)
+    {
+        udp_hc                         = udp_hc ? udp_hc : 0xffff;
+        body[UDP_CHKSUM_OFFSET]        = udp_hc >> 8;
+        body[UDP_CHKSUM_OFFSET+1]      = udp_hc & 0xff;
+    }
+
+    // Multicast and broadcast destinations go to the corresponding MAC address, as for genUdpIpPkt()
+    if (field == FIELD_DST_IP)
+    {
+        uint64_t mac                   = udpIpPg::isIpv4Mcast(val)             ? udpIpPg::ipv4McastMac(val)  :
+                                         pUdp->isIpv4Bcast(val)                ? udpIpPg::MAC_BROADCAST_ADDR :
+                                                                                 mac_dst_addr;
+        for (uint32_t bidx = 0; bidx < 6; bidx++)
+        {
+            body[bidx]                 = (mac >> (8*(5-bidx))) & 0xff;
+        }
+    }
+
+    cur[field]                         = val;
+}
+
+// --------------------------------------------------
+// Recalculate the frame's FCS
+// --------------------------------------------------
+
+void udpFlowSweep::updateFcs (void)
+{
+    uint32_t        eof                = 0;
+
+#ifdef GENERATE_SOF_EOF
+    eof                                = (frame[frame_len-1] == udpVProc::EoF) ? 1 : 0;
+#endif
+
+    uint32_t*       body               = &frame[body_start];
+    uint32_t        body_len           = frame_len - eof - body_start;
+    const uint32_t* table              = udpVProc::UdpVpCrcTable();
+    uint32_t        crc                = udpVProc::INIT;
+
+    for (uint32_t bidx = 0; bidx < body_len - udpVProc::ETH_CRC_LEN; bidx++)
+    {
+        crc                            = table[(crc ^ body[bidx]) & 0xff] ^ (crc >> 8);
+    }
+
+    crc                                ^= 0xffffffff;
+
+    for (uint32_t bidx = 0; bidx < udpVProc::ETH_CRC_LEN; bidx++)
+    {
+        body[body_len - udpVProc::ETH_CRC_LEN + bidx] = (crc >> (8*bidx)) & 0xff;
+    }
+}
+
+// --------------------------------------------------
+// Random number generation (xorshift64*)
+// --------------------------------------------------
+
+uint64_t udpFlowSweep::rand64 (void)
+{
+    state                              ^= state >> 12;
+    state                              ^= state << 25;
+    state                              ^= state >> 27;
+
+    return state * 0x2545f4914f6cdd1dULL;
+}
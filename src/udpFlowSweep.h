@@ -0,0 +1,193 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for UDP/IPv4 flow sweep generation
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_FLOW_SWEEP_H_
+#define _UDP_FLOW_SWEEP_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#include "udpIpPg.h"
+
+// -------------------------------------------------------------
+// Flow sweep generator, for stressing flow tables and hashing
+// with large numbers of 5-tuples. A base frame is built once
+// with genUdpIpPkt(), and each following frame is made by
+// patching the source and destination addresses and ports of
+// the previous one in place. The IPv4 header and UDP checksums
+// are updated incrementally (RFC 1624, eqn. 3) and only the FCS
+// is recalculated.
+//
+// Each field has a range of values (first, count, step). In
+// sequential mode the ranges are stepped through like an
+// odometer, with FIELD_SRC_PORT varying fastest, so every
+// combination is generated once before repeating. In random
+// mode each field's value is picked at random from its range
+// for every frame. The payload and MAC addresses are those of
+// the base frame, except for multicast and broadcast
+// destinations, which get the corresponding MAC address.
+// -------------------------------------------------------------
+
+class udpFlowSweep
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Swept fields, in order of odometer significance
+    static const uint32_t FIELD_SRC_PORT       = 0;
+    static const uint32_t FIELD_DST_PORT       = 1;
+    static const uint32_t FIELD_SRC_IP         = 2;
+    static const uint32_t FIELD_DST_IP         = 3;
+    static const uint32_t NUM_FIELDS           = 4;
+
+    // Largest frame, including preamble and any SOF/EOF tokens
+    static const uint32_t MAX_FRAME_LEN        = udpVProc::ETH_MTU        + udpVProc::ETH_HDR_LEN  +
+                                                 udpVProc::ETH_PREAMBLE   + udpVProc::ETH_CRC_LEN  +
+                                                 udpVProc::ETH_802_1Q_LEN + 2; // BYTES
+
+    // Field offsets from the start of the frame body (destination MAC address)
+    static const uint32_t IPV4_CHKSUM_OFFSET   = udpVProc::ETH_HDR_LEN + 10;
+    static const uint32_t IPV4_SRC_OFFSET      = udpVProc::ETH_HDR_LEN + 12;
+    static const uint32_t IPV4_DST_OFFSET      = udpVProc::ETH_HDR_LEN + 16;
+    static const uint32_t UDP_SRC_PORT_OFFSET  = udpVProc::ETH_HDR_LEN + 20;
+    static const uint32_t UDP_DST_PORT_OFFSET  = udpVProc::ETH_HDR_LEN + 22;
+    static const uint32_t UDP_CHKSUM_OFFSET    = udpVProc::ETH_HDR_LEN + 26;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Range of values for a field: first, first+step, ... (count values)
+    typedef struct {
+        uint32_t          first;
+        uint32_t          count;
+        uint32_t          step;
+    } fieldRange_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpFlowSweep (udpIpPg* pUdpIn) : pUdp(pUdpIn)
+    {
+        for (uint32_t field = 0; field < NUM_FIELDS; field++)
+        {
+            ranges[field]              = {0, 0, 1};
+            idx[field]                 = 0;
+            cur[field]                 = 0;
+        }
+
+        random                         = false;
+        state                          = 1;
+        frame_len                      = 0;
+        body_start                     = 0;
+        udp_chksum_on                  = false;
+        mac_dst_addr                   = 0;
+        frames_gen                     = 0;
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to set a field's range. A count of 0 leaves the field at its base frame
+    // value. Returns false on error.
+    bool           setRange            (uint32_t field, uint32_t first, uint32_t count, uint32_t step = 1);
+
+    // Method to select random, rather than sequential, field values
+    void           setRandom           (bool randomIn, uint64_t seed = 1) {random = randomIn; state = seed ? seed : 1;};
+
+    // Method to build the base frame, and set the first flow's values. Returns the
+    // frame length in bytes, or 0 on error.
+    uint32_t       init                (udpIpPg::udpConfig_t &cfg, uint32_t* payload, uint32_t payload_len);
+
+    // Method to return the frame for the next flow of the sweep, and its length
+    uint32_t*      next                (uint32_t &len);
+
+    // Method to send a number of frames, with ifg_ticks idle cycles after each,
+    // returning the number sent
+    uint64_t       send                (uint64_t num_frames, uint32_t ifg_ticks = 0);
+
+    // Number of distinct flows in the sweep
+    uint64_t       numFlows            (void);
+
+    // Current field value, and number of frames generated
+    uint32_t       getField            (uint32_t field) {return field < NUM_FIELDS ? cur[field] : 0;};
+    uint64_t       getFramesGen        (void)           {return frames_gen;};
+
+    // RFC 1624 incremental update of a checksum hc for a 16 bit word changing from m to m_new
+    static uint32_t chksumUpdate       (uint32_t hc, uint32_t m, uint32_t m_new);
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to choose the next set of field values
+    void           advance             (void);
+
+    // Method to write a field value into the frame, updating the checksums
+    void           patchField          (uint32_t field, uint32_t val);
+
+    // Method to recalculate the FCS of the frame
+    void           updateFcs           (void);
+
+    // Random number generation (xorshift64*)
+    uint64_t       rand64              (void);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node's packet generator
+    udpIpPg*       pUdp;
+
+    // Field ranges, current odometer indexes and current values
+    fieldRange_t   ranges[NUM_FIELDS];
+    uint32_t       idx[NUM_FIELDS];
+    uint32_t       cur[NUM_FIELDS];
+
+    // Random selection and generator state
+    bool           random;
+    uint64_t       state;
+
+    // Frame being patched, its length, and the offset of the destination MAC address
+    uint32_t       frame[MAX_FRAME_LEN];
+    uint32_t       frame_len;
+    uint32_t       body_start;
+
+    // Set if the base frame carried a UDP checksum
+    bool           udp_chksum_on;
+
+    // Destination MAC address for unicast destinations
+    uint64_t       mac_dst_addr;
+
+    // Number of frames generated
+    uint64_t       frames_gen;
+};
+
+#endif
@@ -0,0 +1,156 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for background UDP/IPv4 frame
+// generation
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include "udpFrameGen.h"
+
+// --------------------------------------------------
+// Start the producer thread
+// --------------------------------------------------
+
+void udpFrameGen::start (void)
+{
+    if (running)
+    {
+        printf("udpFrameGen::start() : ***ERROR. Producer thread already running\n");
+        return;
+    }
+
+    done                               = false;
+    abort                              = false;
+    running                            = true;
+
+    thread                             = std::thread(&udpFrameGen::producer, this);
+}
+
+// --------------------------------------------------
+// Stop the producer thread
+// --------------------------------------------------
+
+void udpFrameGen::stop (void)
+{
+    if (running)
+    {
+        abort                          = true;
+        thread.join();
+        running                        = false;
+    }
+}
+
+// --------------------------------------------------
+// Producer thread. Builds each described frame
+// directly into the next free ring slot, yielding
+// whilst the ring is full.
+// --------------------------------------------------
+
+void udpFrameGen::producer (void)
+{
+    uint32_t payload[udpPayload::MAX_PAYLOAD_LEN];
+
+    for (auto &desc : traffic)
+    {
+        udpPayload gen(desc.pattern, desc.flow, desc.seed);
+
+        for (uint32_t fidx = 0; fidx < desc.num_frames; fidx++)
+        {
+            frameSlot_t* slot;
+
+            while ((slot = ring.reserve()) == NULL)
+            {
+                if (abort)
+                {
+                    return;
+                }
+                std::this_thread::yield();
+            }
+
+            uint32_t payloadlen        = gen.fill(payload, desc.payload_len);
+
+            slot->len                  = pUdp->genUdpIpPkt(desc.cfg, slot->frame, payload, payloadlen);
+            slot->ifg_ticks            = desc.ifg_ticks;
+
+            ring.commit();
+        }
+    }
+
+    done                               = true;
+}
+
+// --------------------------------------------------
+// Send the next frame from the ring. If the producer
+// has fallen behind, the node idles for a tick so
+// that the simulation is not stalled.
+// --------------------------------------------------
+
+bool udpFrameGen::sendNext (void)
+{
+    frameSlot_t* slot                  = ring.front();
+
+    if (slot == NULL)
+    {
+        // Check done before looking at the ring again, as the producer
+        // may have committed its last frame in between
+        if (!running || (done && ring.empty()))
+        {
+            return false;
+        }
+
+        pUdp->UdpVpSendIdle(1);
+        starved_ticks++;
+
+        return true;
+    }
+
+    pUdp->UdpVpSendRawEthFrame(slot->frame, slot->len);
+
+    if (slot->ifg_ticks)
+    {
+        pUdp->UdpVpSendIdle(slot->ifg_ticks);
+    }
+
+    ring.release();
+    frames_sent++;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Send all the described traffic
+// --------------------------------------------------
+
+uint32_t udpFrameGen::sendAll (void)
+{
+    uint64_t start_count               = frames_sent;
+
+    if (!running)
+    {
+        start();
+    }
+
+    while (sendNext())
+        ;
+
+    stop();
+
+    return frames_sent - start_count;
+}
@@ -0,0 +1,152 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for background UDP/IPv4 frame generation
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_FRAME_GEN_H_
+#define _UDP_FRAME_GEN_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+#include "udpIpPg.h"
+#include "udpPayload.h"
+#include "udpSpscRing.h"
+
+// -------------------------------------------------------------
+// Optional frame generator that builds frames from a traffic
+// description on a separate producer thread, so that CRC and
+// checksum calculations overlap with simulation time. The VProc
+// user thread just dequeues the finished frames and drives them
+// with sendNext() or sendAll().
+// -------------------------------------------------------------
+
+class udpFrameGen
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Number of pre-built frames that can be queued (power of 2)
+    static const uint32_t RING_ENTRIES         = 64;
+
+    // Largest frame, including preamble and any SOF/EOF tokens
+    static const uint32_t MAX_FRAME_LEN        = udpVProc::ETH_MTU        + udpVProc::ETH_HDR_LEN  +
+                                                 udpVProc::ETH_PREAMBLE   + udpVProc::ETH_CRC_LEN  +
+                                                 udpVProc::ETH_802_1Q_LEN + 2; // BYTES
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Description of a run of frames for a single flow
+    typedef struct {
+        udpIpPg::udpConfig_t cfg;
+        uint32_t             payload_len;   // BYTES (>= udpPayload::HDR_LEN)
+        uint32_t             pattern;       // udpPayload pattern type
+        uint32_t             flow;
+        uint32_t             seed;
+        uint32_t             num_frames;
+        uint32_t             ifg_ticks;     // Idle ticks after each frame
+    } trafficDesc_t;
+
+    // A pre-built frame ring slot
+    typedef struct {
+        uint32_t             len;
+        uint32_t             ifg_ticks;
+        uint32_t             frame[MAX_FRAME_LEN];
+    } frameSlot_t;
+
+    // --------------------------------------------
+    // Constructor/destructor
+    // --------------------------------------------
+
+    udpFrameGen  (udpIpPg* pUdpIn) : pUdp(pUdpIn), running(false), done(false), abort(false)
+    {
+        frames_sent                    = 0;
+        starved_ticks                  = 0;
+    };
+
+    ~udpFrameGen () {stop();};
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to add traffic to the description (before calling start())
+    void           addTraffic          (const trafficDesc_t &desc) {traffic.push_back(desc);};
+
+    // Method to start the producer thread
+    void           start               (void);
+
+    // Method to stop the producer thread, discarding any unsent frames
+    void           stop                (void);
+
+    // Method to send the next pre-built frame, idling if none ready yet. Returns
+    // false once all the described traffic has been sent.
+    bool           sendNext            (void);
+
+    // Method to send all the described traffic, returning the number of frames sent
+    uint32_t       sendAll             (void);
+
+    // Statistics
+    uint64_t       getFramesSent       (void) {return frames_sent;};
+    uint64_t       getStarvedTicks     (void) {return starved_ticks;};
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Producer thread main loop
+    void           producer            (void);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node's packet generator
+    udpIpPg*                           pUdp;
+
+    // Traffic to generate
+    std::vector<trafficDesc_t>         traffic;
+
+    // Producer thread and its state flags
+    std::thread                        thread;
+    bool                               running;
+    std::atomic<bool>                  done;
+    std::atomic<bool>                  abort;
+
+    // Ring of pre-built frames
+    udpSpscRing<frameSlot_t, RING_ENTRIES> ring;
+
+    // Consumer statistics
+    uint64_t                           frames_sent;
+    uint64_t                           starved_ticks;
+};
+
+#endif
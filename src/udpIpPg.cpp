@@ -78,6 +78,20 @@ uint32_t udpIpPg::ipv4_chksum (uint32_t* buf, uint32_t len, bool debug)
     return sum;
 }
 
+// --------------------------------------------------
+// Fold a 32 bit checksum sum into a 16 bit one's
+// complement checksum. Folded twice, as the first
+// fold can itself generate a carry.
+// --------------------------------------------------
+
+uint32_t udpIpPg::ipv4_fold (uint32_t sum)
+{
+    sum                                = (sum & 0xffff) + (sum >> 16);
+    sum                                = (sum & 0xffff) + (sum >> 16);
+
+    return ~sum & 0xffff;
+}
+
 // --------------------------------------------------
 // Generate a UDP/IP packet. Parameters passed in
 // with cfg, and any data in payload (with payload
@@ -87,6 +101,8 @@ uint32_t udpIpPg::ipv4_chksum (uint32_t* buf, uint32_t len, bool debug)
 
 uint32_t udpIpPg::genUdpIpPkt (udpConfig_t &cfg, uint32_t* frm_buf, uint32_t* payload, uint32_t payload_len)
 {
+    UDP_PROF_SCOPE(prof, PROF_GEN);
+
     // Intermediate buffers for UDP and IPV4 data
     uint32_t udp_payload[2048];
     uint32_t ipv4_payload[2048];
@@ -101,13 +117,86 @@ uint32_t udpIpPg::genUdpIpPkt (udpConfig_t &cfg, uint32_t* frm_buf, uint32_t* pa
     // Data places in ipv4_payload and method returns total length.
     uint32_t iplen  = ipv4Frame (ipv4_payload, udp_payload, udplen, cfg.ip_dst_addr);
 
+    // Multicast and broadcast packets always go to the corresponding MAC address
+    uint64_t mac_dst_addr = isIpv4Mcast(cfg.ip_dst_addr)               ? ipv4McastMac(cfg.ip_dst_addr) :
+                            isIpv4Bcast(cfg.ip_dst_addr)               ? MAC_BROADCAST_ADDR :
+                                                                         cfg.mac_dst_addr;
+
     // Wrap IPV4 Frame in an ethernet frame, placing in frm_buf and returning total length of data
-    uint32_t flen   = ethFrame  (frm_buf, ipv4_payload, iplen, cfg.mac_dst_addr);
+    uint32_t flen   = ethFrame  (frm_buf, ipv4_payload, iplen, mac_dst_addr);
 
     // Return length of data in bytes.
     return flen;
 }
 
+// --------------------------------------------------
+// Generate an 802.3x PAUSE frame, to the reserved
+// MAC control multicast address
+// --------------------------------------------------
+
+uint32_t udpIpPg::genPauseFrame (uint32_t* frm_buf, uint32_t quanta)
+{
+    uint32_t payload[4];
+
+    payload[0]                         = (MAC_CTRL_PAUSE >> 8) & 0xff;
+    payload[1]                         = MAC_CTRL_PAUSE & 0xff;
+    payload[2]                         = (quanta >> 8) & 0xff;
+    payload[3]                         = quanta & 0xff;
+
+    return ethFrame(frm_buf, payload, 4, MAC_CTRL_ADDR, ETH_TYPE_MAC_CTRL);
+}
+
+// --------------------------------------------------
+// Generate an 802.1Qbb PFC frame, with a class
+// enable vector and a time for each priority
+// --------------------------------------------------
+
+uint32_t udpIpPg::genPfcFrame (uint32_t* frm_buf, uint32_t enable, const uint32_t quanta[PFC_PRIORITIES])
+{
+    uint32_t payload[4 + 2*PFC_PRIORITIES];
+    uint32_t pidx                      = 0;
+
+    payload[pidx++]                    = (MAC_CTRL_PFC >> 8) & 0xff;
+    payload[pidx++]                    = MAC_CTRL_PFC & 0xff;
+    payload[pidx++]                    = 0;
+    payload[pidx++]                    = enable & 0xff;
+
+    // Times for priorities not enabled are sent, but ignored by the receiver
+    for (uint32_t pri = 0; pri < PFC_PRIORITIES; pri++)
+    {
+        uint32_t time                  = (enable & (1 << pri)) ? quanta[pri] : 0;
+
+        payload[pidx++]                = (time >> 8) & 0xff;
+        payload[pidx++]                = time & 0xff;
+    }
+
+    return ethFrame(frm_buf, payload, pidx, MAC_CTRL_ADDR, ETH_TYPE_MAC_CTRL);
+}
+
+// --------------------------------------------------
+// Send PAUSE and PFC frames
+// --------------------------------------------------
+
+uint32_t udpIpPg::sendPause (uint32_t quanta)
+{
+    uint32_t frm_buf[MAC_CTRL_FRAME_LEN];
+    uint32_t len                       = genPauseFrame(frm_buf, quanta);
+
+    UdpVpGetPauseStats().tx_pause_frames++;
+
+    return UdpVpSendRawEthFrame(frm_buf, len);
+}
+
+uint32_t udpIpPg::sendPfc (uint32_t enable, const uint32_t quanta[PFC_PRIORITIES])
+{
+    uint32_t frm_buf[MAC_CTRL_FRAME_LEN];
+    uint32_t len                       = genPfcFrame(frm_buf, enable, quanta);
+
+    UdpVpGetPauseStats().tx_pfc_frames++;
+
+    return UdpVpSendRawEthFrame(frm_buf, len);
+}
+
 // --------------------------------------------------
 // Construct UDP segment
 // -------------------------------------------------
@@ -203,7 +292,7 @@ uint32_t udpIpPg::ipv4Frame (uint32_t* ipv4_frame, uint32_t* payload, uint32_t p
     uint32_t chksum                    = ipv4_chksum(ipv4_frame, fidx);
 
     // One's complement checksum
-    chksum = ~((chksum & 0xffff) + (chksum >> 16)) & 0xffff;
+    chksum = ipv4_fold(chksum);
 
     // Add the IPV4 checksum
     ipv4_frame[chksum_offset]          = chksum >> 8;
@@ -237,7 +326,7 @@ uint32_t udpIpPg::ipv4Frame (uint32_t* ipv4_frame, uint32_t* payload, uint32_t p
         partial_chksum                 += (payload_len);
 
         // One's complement checksum
-        partial_chksum                 = ~((partial_chksum & 0xffff) + (partial_chksum >> 16)) & 0xffff;
+        partial_chksum                 = ipv4_fold(partial_chksum);
 
         // Write UDP checksum to buffer
         ipv4_frame[payload_offset + UDP_CHKSUM_OFFSET]   = partial_chksum >> 8;
@@ -253,7 +342,7 @@ uint32_t udpIpPg::ipv4Frame (uint32_t* ipv4_frame, uint32_t* payload, uint32_t p
 // Construct ethernet frame
 // --------------------------------------------------
 
-uint32_t udpIpPg::ethFrame(uint32_t* frame, uint32_t* payload, uint32_t payload_len, uint64_t dst_addr)
+uint32_t udpIpPg::ethFrame(uint32_t* frame, uint32_t* payload, uint32_t payload_len, uint64_t dst_addr, uint32_t eth_type)
 {
     uint32_t fidx                      = 0;
 
@@ -293,8 +382,8 @@ uint32_t udpIpPg::ethFrame(uint32_t* frame, uint32_t* payload, uint32_t payload_
     }
 
     // Add 2 bytes of Ethernet type (0x800 = IPv4)
-    frame[fidx++]                      = 0x08;
-    frame[fidx++]                      = 0x00;
+    frame[fidx++]                      = (eth_type >> 8) & 0xff;
+    frame[fidx++]                      = eth_type & 0xff;
 
     // Add the payload
     for (int idx = 0; idx < payload_len; idx++)
@@ -330,12 +419,225 @@ uint32_t udpIpPg::ethFrame(uint32_t* frame, uint32_t* payload, uint32_t payload_
 
 }
 
+// --------------------------------------------------
+// Wait for a packet to be received for the given
+// UDP port, or until timeout ticks have passed.
+// Packets for other ports are still delivered to
+// any registered callback whilst waiting. Returns
+// true, with the tick at which the packet completed
+// in tick, or false on timeout.
+// --------------------------------------------------
+
+bool udpIpPg::waitForRx (uint32_t port, uint32_t timeoutTicks, uint32_t &tick)
+{
+    uint32_t start_tick                = UdpVpGetTicks();
+
+    while (true)
+    {
+        uint32_t remaining             = RX_WAIT_FOREVER;
+
+        if (timeoutTicks != RX_WAIT_FOREVER)
+        {
+            uint32_t elapsed           = UdpVpGetTicks() - start_tick;
+
+            if (elapsed >= timeoutTicks)
+            {
+                return false;
+            }
+
+            remaining                  = timeoutTicks - elapsed;
+        }
+
+        if (!UdpVpWaitForRx(remaining, tick))
+        {
+            return false;
+        }
+
+        if (rx_last_port == port)
+        {
+            return true;
+        }
+    }
+}
+
+// --------------------------------------------------
+// Join an IPv4 multicast group, adding its MAC
+// address to the receive filter on first join
+// --------------------------------------------------
+
+bool udpIpPg::joinGroup (uint32_t group)
+{
+    if (!isIpv4Mcast(group))
+    {
+        return false;
+    }
+
+    if (mcast_groups[group]++ == 0)
+    {
+        updateMcastFilter();
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Leave an IPv4 multicast group, removing it from
+// the receive filter when left as often as joined
+// --------------------------------------------------
+
+bool udpIpPg::leaveGroup (uint32_t group)
+{
+    auto it                            = mcast_groups.find(group);
+
+    if (it == mcast_groups.end())
+    {
+        return false;
+    }
+
+    if (--it->second == 0)
+    {
+        mcast_groups.erase(it);
+        updateMcastFilter();
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Select the number of multicast hash filter bins
+// --------------------------------------------------
+
+bool udpIpPg::setMcastHashBins (uint32_t bins)
+{
+    if (bins != MCAST_HASH_BINS_64 && bins != MCAST_HASH_BINS_512)
+    {
+        return false;
+    }
+
+    mcast_hash_bins                    = bins;
+    updateMcastFilter();
+
+    return true;
+}
+
+// --------------------------------------------------
+// Set the subnet mask. Ones must be contiguous from
+// the top bit, so the host bits (~mask) plus one is
+// a power of 2.
+// --------------------------------------------------
+
+bool udpIpPg::setSubnetMask (uint32_t mask)
+{
+    uint32_t host                      = ~mask;
+
+    if (host & (host + 1))
+    {
+        printf("udpIpPg::setSubnetMask() : ***ERROR. Non-contiguous subnet mask (0x%08x)\n", mask);
+        return false;
+    }
+
+    ipv4_subnet_mask                   = mask;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Rebuild the multicast MAC filter, as MAC hardware
+// drivers do on a change of group membership. The
+// first MCAST_PERFECT_ENTRIES distinct MAC addresses
+// use exact match entries, and any others set bins
+// in the hash filter. Several groups can map to one
+// MAC address, so the IP layer makes the final check.
+// --------------------------------------------------
+
+void udpIpPg::updateMcastFilter (void)
+{
+    mcast_perfect_count                = 0;
+    mcast_hash_used                    = false;
+
+    for (uint32_t idx = 0; idx < MCAST_HASH_BINS_512/64; idx++)
+    {
+        mcast_hash[idx]                = 0;
+    }
+
+    for (auto &grp : mcast_groups)
+    {
+        uint64_t mac                   = ipv4McastMac(grp.first);
+        bool     found                 = false;
+
+        for (uint32_t idx = 0; idx < mcast_perfect_count && !found; idx++)
+        {
+            found                      = mcast_perfect[idx] == mac;
+        }
+
+        if (found)
+        {
+            continue;
+        }
+
+        if (mcast_perfect_count < MCAST_PERFECT_ENTRIES)
+        {
+            mcast_perfect[mcast_perfect_count++] = mac;
+        }
+        else
+        {
+            uint32_t bin               = mcastHashBin(mac);
+            mcast_hash[bin >> 6]       |= 1ULL << (bin & 0x3f);
+            mcast_hash_used            = true;
+        }
+    }
+}
+
+// --------------------------------------------------
+// Hash filter bin for a MAC address: the low bits of
+// the Ethernet CRC-32 of the six address bytes
+// --------------------------------------------------
+
+uint32_t udpIpPg::mcastHashBin (uint64_t mac)
+{
+    uint32_t buf[6];
+
+    for (int idx = 0; idx < 6; idx++)
+    {
+        buf[idx]                       = (mac >> (40 - idx*8)) & 0xff;
+    }
+
+    return crc32(buf, 6) & (mcast_hash_bins - 1);
+}
+
+// --------------------------------------------------
+// Check a multicast MAC address against the exact
+// match entries, then the hash filter
+// --------------------------------------------------
+
+bool udpIpPg::mcastMacMatch (uint64_t mac)
+{
+    for (uint32_t idx = 0; idx < mcast_perfect_count; idx++)
+    {
+        if (mcast_perfect[idx] == mac)
+        {
+            return true;
+        }
+    }
+
+    if (!mcast_hash_used)
+    {
+        return false;
+    }
+
+    uint32_t bin                       = mcastHashBin(mac);
+
+    return (mcast_hash[bin >> 6] >> (bin & 0x3f)) & 1;
+}
+
 // --------------------------------------------------
 // Process the received frames
 // --------------------------------------------------
 
 uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
 {
+    UDP_PROF_SCOPE(prof, PROF_RX);
+
     uint32_t error                     = 0;
 
     rxInfo_t rxInfo;
@@ -344,17 +646,33 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
     // MAC
     // -------------------------
 
-    // Check frame's CRC
-    uint32_t crc                       = crc32(rx_data, rx_len-4);
-    uint32_t pktcrc                    = rx_data[rx_len-1] << 24 |
+    // Check frame's CRC, as accumulated by the receiver as the frame arrived
+    if (!rx_crc_good)
+    {
+        if (rx_len < ETH_CRC_LEN)
+        {
+            error                      |= RX_BAD_CRC;
+            UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: received packet too short (%d bytes)\n", node, rx_len);
+            return error;
+        }
+
+        // Only calculate the expected value for reporting when the check has failed
+        uint32_t crc                   = crc32(rx_data, rx_len-4);
+        uint32_t pktcrc                = rx_data[rx_len-1] << 24 |
                                          rx_data[rx_len-2] << 16 |
                                          rx_data[rx_len-3] <<  8 |
                                          rx_data[rx_len-4] <<  0 ;
 
-    if (crc != pktcrc)
+        error                          |= RX_BAD_CRC;
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: bad MAC CRC on received packet (got 0x%08x, exp 0x%08x)\n", node, pktcrc, crc);
+        return error;
+    }
+
+    // Discard runts, as their headers may be incomplete
+    if (rx_len < ETH_MIN_FRAME_LEN)
     {
-        //error                          |= RX_BAD_CRC;
-        printf("WARNING: bad MAC CRC on received packet (got 0x%08x, exp 0x%08x)\n", pktcrc, crc);
+        error                          |= RX_RUNT;
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: runt frame received (%d bytes)\n", node, rx_len);
         return error;
     }
 
@@ -367,10 +685,13 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
                                          (uint64_t)rx_data[ridx++] <<  8 |
                                          (uint64_t)rx_data[ridx++];
 
-    if (dst_mac_addr != mac_addr)
+    // Accept frames for this node, broadcasts, and multicasts passing the group filter
+    bool mac_mcast                     = (dst_mac_addr & MAC_MULTICAST_BIT) && dst_mac_addr != MAC_BROADCAST_ADDR;
+
+    if (dst_mac_addr != mac_addr && dst_mac_addr != MAC_BROADCAST_ADDR && !(mac_mcast && mcastMacMatch(dst_mac_addr)))
     {
-        error                          |= 1; // Incorrect MAC addr
-        printf("WARNING: non-matching MAC address on received packet\n");
+        error                          |= RX_WRONG_MAC_ADDR;
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: non-matching MAC address on received packet\n", node);
         return error;
     }
 
@@ -386,14 +707,15 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
     // IPV4
     // -------------------------
 
-    // Check IP header for integrity and addressed to us and, if so, save src address
-    uint32_t chksum                    = ipv4_chksum(&rx_data[ETH_HDR_LEN], IPV4_MIN_HDR_LEN*4);
-    chksum                             = ~((chksum & 0xffff) + (chksum >> 16)) & 0xffff;
+    // Check IP header for integrity (header sum accumulated on arrival) and addressed to us and,
+    // if so, save src address
+    uint32_t chksum                    = rx_ipv4_hdr_sum;
+    chksum                             = ipv4_fold(chksum);
 
     if (chksum)
     {
         error |= RX_BAD_IPV4_CHECKSUM;
-        printf("WARNING: bad IPV4 checksum on received packet\n");
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: bad IPV4 checksum on received packet\n", node);
         return error;
     }
 
@@ -414,10 +736,22 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
                                          rx_data[ridx++] <<  8 |
                                          rx_data[ridx++];
 
-    if (ipv4_dst_addr != ipv4_addr)
+    rxInfo.ipv4_dst_addr               = ipv4_dst_addr;
+
+    // Accept packets for this node, limited and directed broadcasts, and joined multicast groups.
+    // An unjoined group getting here shared a hash bin (or mapped MAC address) with a joined one.
+    bool ipv4_mcast                    = isIpv4Mcast(ipv4_dst_addr);
+    bool ipv4_bcast                    = isIpv4Bcast(ipv4_dst_addr);
+
+    if (ipv4_mcast && mac_mcast && !isMember(ipv4_dst_addr))
+    {
+        mcast_hash_false_hits++;
+    }
+
+    if (ipv4_dst_addr != ipv4_addr && !ipv4_bcast && !(ipv4_mcast && mac_mcast && isMember(ipv4_dst_addr)))
     {
         error                          |= RX_WRONG_IPV4_ADDR;
-        printf("WARNING: non-matching IPV4 address on received packet\n");
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: non-matching IPV4 address on received packet\n", node);
         return error;
     }
 
@@ -427,8 +761,8 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
 
     // Check UDP segment integrity and correct port. Save src port #
 
-    // Calculate the partial checksum for the UDP segment
-    uint32_t partial_chksum            = ipv4_chksum(&rx_data[ridx], ipv4_payload_len);
+    // Partial checksum for the UDP segment was accumulated on arrival
+    uint32_t partial_chksum            = rx_udp_sum;
 
     // Calculate the rest of the checksum with the IP pseudo-header data
     partial_chksum                     += (rxInfo.ipv4_src_addr >> 16) & 0xffff;
@@ -439,7 +773,7 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
     partial_chksum                     += (ipv4_payload_len);
 
     // One's complement checksum
-    partial_chksum                     = ~((partial_chksum & 0xffff) + (partial_chksum >> 16)) & 0xffff;
+    partial_chksum                     = ipv4_fold(partial_chksum);
 
     // Extract UDP info
     rxInfo.udp_src_port                = rx_data[ridx++] << 8 |
@@ -460,18 +794,21 @@ uint32_t udpIpPg::processFrame (uint32_t* rx_data, uint32_t rx_len)
     if (partial_chksum && udpchksum)
     {
         error                          |= RX_BAD_UDP_CHECKSUM;
-        printf("WARNING: bad UDP checksum on received packet (0x%08x)\n", partial_chksum);
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: bad UDP checksum on received packet (0x%08x)\n", node, partial_chksum);
         return error;
     }
 
     if (false && rxInfo.udp_dst_port != udp_port)
     {
         error                          |= RX_WRONG_UDP_PORT;
-        printf("WARNING: non-matching UDP port number on received packet\n");
+        UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: non-matching UDP port number on received packet\n", node);
         return error;
     }
 
 
+    // Remember the port of the last accepted packet, for waitForRx()
+    rx_last_port                       = rxInfo.udp_dst_port;
+
     // If all checks out, extract payload and call user callback, if one registered
     if (!error && usrRxCbFunc != NULL)
     {
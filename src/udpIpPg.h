@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <unordered_map>
 
 #include "udpVProc.h"
 
@@ -42,16 +43,14 @@ public:
     static const uint32_t minor_version        = 0;
     static const uint32_t patch_version        = 5;
     
-    // CRC32 parameters
-    static const uint32_t POLY                 = 0xEDB88320;  /* 0x04C11DB7 bit reversed */
-    static const uint32_t INIT                 = 0xFFFFFFFF;
-
     // Nominal 10G clock frequency (Hz)
     static const uint32_t CLK10G_FREQ          = 156250000;
 
     // IPv4 parameters
-    static const uint32_t IPV4_MULTICAST_ADDR  = 0x00000000;
-    static const uint32_t IPV4_SUBNET_MASK     = 0xffffffff;
+    static const uint32_t IPV4_MULTICAST_ADDR  = 0xe0000000; // 224.0.0.0/4
+    static const uint32_t IPV4_MULTICAST_MASK  = 0xf0000000;
+    static const uint32_t IPV4_BROADCAST_ADDR  = 0xffffffff;
+    static const uint32_t IPV4_SUBNET_MASK     = 0xffffffff; // Default, with no directed broadcast
     static const uint32_t IPV4_MIN_HDR_LEN     = 5;  // DWORDS
     static const uint32_t IPV4_SRC_ADDR_OFFSET = 3;  // DWORDS
     
@@ -61,6 +60,20 @@ public:
     static const uint32_t UDP_CHKSUM_OFFSET    = 6; // BYTES
     static const uint32_t UDP_PROTOCOL_NUM     = 17;
 
+    // MAC address parameters
+    static const uint64_t MAC_BROADCAST_ADDR   = 0xffffffffffffULL;
+    static const uint64_t MAC_MULTICAST_BIT    = 0x010000000000ULL; // I/G bit of first octet
+    static const uint64_t MAC_IPV4_MCAST_BASE  = 0x01005e000000ULL; // RFC 1112 group mapping
+    static const uint32_t MAC_IPV4_MCAST_MASK  = 0x007fffff;        // Low 23 bits of group address
+
+    // Largest MAC control frame, including preamble and any SOF/EOF tokens
+    static const uint32_t MAC_CTRL_FRAME_LEN   = ETH_PREAMBLE + ETH_HDR_LEN + 46 + ETH_CRC_LEN + 2; // BYTES
+
+    // Multicast receive filter parameters
+    static const uint32_t MCAST_PERFECT_ENTRIES = 16;
+    static const uint32_t MCAST_HASH_BINS_64   = 64;
+    static const uint32_t MCAST_HASH_BINS_512  = 512;
+
     // Receiver error masks
     static const uint32_t RX_BAD_CRC           = 0x0001;
     static const uint32_t RX_WRONG_MAC_ADDR    = 0x0002;
@@ -68,6 +81,7 @@ public:
     static const uint32_t RX_WRONG_IPV4_ADDR   = 0x0008;
     static const uint32_t RX_BAD_UDP_CHECKSUM  = 0x0010;
     static const uint32_t RX_WRONG_UDP_PORT    = 0x0020;
+    static const uint32_t RX_RUNT              = 0x0040;
 
     // --------------------------------------------
     // Type definitions
@@ -77,6 +91,7 @@ public:
     typedef struct {
         uint64_t mac_src_addr;
         uint32_t ipv4_src_addr;
+        uint32_t ipv4_dst_addr;
         uint32_t udp_src_port;
         uint32_t udp_dst_port;
         uint8_t  rx_payload[ETH_MTU];
@@ -110,6 +125,13 @@ public:
                                         udp_port(udpPortIn)
     {
         usrRxCbFunc                    = NULL;
+        rx_last_port                   = 0;
+
+        ipv4_subnet_mask               = IPV4_SUBNET_MASK;
+
+        mcast_hash_bins                = MCAST_HASH_BINS_64;
+        mcast_hash_false_hits          = 0;
+        updateMcastFilter();
     };
 
     // --------------------------------------------
@@ -121,7 +143,50 @@ public:
 
     // Method to generate a UDP/IPv4 packet
     uint32_t       genUdpIpPkt         (udpConfig_t &cfg, uint32_t* frm_buf, uint32_t* payload, uint32_t payload_len);
+
+    // Methods to generate an 802.3x PAUSE frame, for quanta of 512 bit times (0 to cancel
+    // a pause), and an 802.1Qbb PFC frame, pausing each priority enabled in the bottom 8
+    // bits of enable for its entry in quanta. Return the frame length.
+    uint32_t       genPauseFrame       (uint32_t* frm_buf, uint32_t quanta);
+    uint32_t       genPfcFrame         (uint32_t* frm_buf, uint32_t enable, const uint32_t quanta[PFC_PRIORITIES]);
+
+    // Methods to generate and send PAUSE and PFC frames. These are never held back by a
+    // pause of the node's own TX.
+    uint32_t       sendPause           (uint32_t quanta);
+    uint32_t       sendPfc             (uint32_t enable, const uint32_t quanta[PFC_PRIORITIES]);
     
+    // Methods to wait for a received packet (on any port, or a given port), with
+    // timeout in ticks. Return false on timeout, else true with the tick the packet
+    // completed in tick.
+    bool           waitForRx           (uint32_t timeoutTicks = RX_WAIT_FOREVER) {return UdpVpWaitForRx(timeoutTicks);};
+    bool           waitForRx           (uint32_t timeoutTicks, uint32_t &tick) {return UdpVpWaitForRx(timeoutTicks, tick);};
+    bool           waitForRx           (uint32_t port, uint32_t timeoutTicks, uint32_t &tick);
+
+    // IGMP-style multicast group membership. Joins are counted, so a group is left
+    // when it has been left as many times as joined. Return false if not a multicast address.
+    bool           joinGroup           (uint32_t group);
+    bool           leaveGroup          (uint32_t group);
+    bool           isMember            (uint32_t group) {return mcast_groups.find(group) != mcast_groups.end();};
+
+    // Method to select the number of multicast hash filter bins (MCAST_HASH_BINS_64 or _512)
+    bool           setMcastHashBins    (uint32_t bins);
+
+    // Count of multicast frames passed by the hash filter, but for groups not joined
+    uint64_t       getMcastHashFalseHits (void) {return mcast_hash_false_hits;};
+
+    // Method to set the node's subnet mask, for directed broadcasts to its subnet. The
+    // mask must have contiguous ones from the top bit. Returns false if not.
+    bool           setSubnetMask       (uint32_t mask);
+
+    // Method to test for limited, or directed (to this node's subnet), broadcast addresses.
+    // A /31 or /32 subnet has no directed broadcast address.
+    bool           isIpv4Bcast         (uint32_t addr)  {return addr == IPV4_BROADCAST_ADDR ||
+                                                                (~ipv4_subnet_mask > 1 && addr == (ipv4_addr | ~ipv4_subnet_mask));};
+
+    // Methods to test for, and map to a MAC address, IPv4 multicast groups
+    static bool    isIpv4Mcast         (uint32_t addr)  {return (addr & IPV4_MULTICAST_MASK) == IPV4_MULTICAST_ADDR;};
+    static uint64_t ipv4McastMac       (uint32_t group) {return MAC_IPV4_MCAST_BASE | (group & MAC_IPV4_MCAST_MASK);};
+
     void           getVersionString    (char* version_str, uint32_t maxlen = 12) {
                                             snprintf(version_str, maxlen, "%d.%d.%d", major_version, minor_version, patch_version);} 
 
@@ -132,7 +197,8 @@ private:
     // --------------------------------------------
     
     // Method to construct an ethernet frame with (optional) payload
-    uint32_t       ethFrame            (uint32_t* eth_frame,  uint32_t* payload, uint32_t payload_len, uint64_t dst_addr);
+    uint32_t       ethFrame            (uint32_t* eth_frame,  uint32_t* payload, uint32_t payload_len, uint64_t dst_addr,
+                                        uint32_t  eth_type = ETH_TYPE_IPV4);
     
     
     // Method to construct an IPV4 frame with (optional) payload
@@ -156,10 +222,22 @@ private:
     
     // Method to calculate IP4v checksum. Also used (in ipv4frame) to calculate UDP checksum
     uint32_t       ipv4_chksum         (uint32_t* buf, uint32_t len, bool debug = false);
+
+    // Method to fold a checksum sum to its 16 bit one's complement value
+    uint32_t       ipv4_fold           (uint32_t sum);
     
     // Method to extract receive data
     void           extractRx           (void);
 
+    // Method to rebuild the multicast MAC filter from the joined groups
+    void           updateMcastFilter   (void);
+
+    // Method to return the multicast hash filter bin for a MAC address
+    uint32_t       mcastHashBin        (uint64_t mac);
+
+    // Method to check a multicast destination MAC address against the filter
+    bool           mcastMacMatch       (uint64_t mac);
+
     // --------------------------------------------
     // Private member variables
     // --------------------------------------------
@@ -167,12 +245,27 @@ private:
     // This node's UDP port number
     uint32_t       udp_port;
     
-    // This node's IPV4 address
+    // This node's IPV4 address, and subnet mask
     uint32_t       ipv4_addr;
+    uint32_t       ipv4_subnet_mask;
     
     // This node's MAC address
     uint64_t       mac_addr;
 
+    // Destination UDP port of the last accepted packet
+    uint32_t       rx_last_port;
+
+    // Joined multicast groups, with join counts
+    std::unordered_map<uint32_t, uint32_t> mcast_groups;
+
+    // Multicast MAC filter: perfect (exact match) entries, then hash bins for the remainder
+    uint64_t       mcast_perfect[MCAST_PERFECT_ENTRIES];
+    uint32_t       mcast_perfect_count;
+    uint64_t       mcast_hash[MCAST_HASH_BINS_512/64];
+    uint32_t       mcast_hash_bins;
+    bool           mcast_hash_used;
+    uint64_t       mcast_hash_false_hits;
+
     // Pointer to the user's receive callback function
     pUsrRxCbFunc_t usrRxCbFunc;
     
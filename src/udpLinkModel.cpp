@@ -0,0 +1,336 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for a link impairment model
+// between two nodes
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <string.h>
+#include <cinttypes>
+
+#include "udpLinkModel.h"
+
+static_assert(!(udpLinkModel::WHEEL_SLOTS & (udpLinkModel::WHEEL_SLOTS-1)), "udpLinkModel WHEEL_SLOTS must be a power of 2");
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+udpLinkModel::udpLinkModel (uint64_t seed, uint32_t pool_frames) :
+                             pool((size_t)pool_frames * MAX_FRAME_LEN),
+                             frame_info(pool_frames),
+                             wheel(WHEEL_SLOTS)
+{
+    for (uint32_t dir = 0; dir < NUM_DIRS; dir++)
+    {
+        config[dir]                    = idealConfig();
+        stats[dir]                     = {0, 0, 0, 0, 0, 0, 0};
+        ge_bad[dir]                    = false;
+        last_due[dir]                  = 0;
+    }
+
+    // Free slots are taken from the back, so fill in reverse to use slot 0 first
+    for (uint32_t slot = pool_frames; slot > 0; slot--)
+    {
+        free_slots.push_back(slot-1);
+    }
+
+    wheel_tick                         = 0;
+    num_pending                        = 0;
+    advancing                          = false;
+    state                              = seed ? seed : 1;
+    pDeliverFunc                       = NULL;
+    hdl                                = NULL;
+}
+
+// --------------------------------------------------
+// Configuration with no impairments
+// --------------------------------------------------
+
+udpLinkModel::linkConfig_t udpLinkModel::idealConfig (void)
+{
+    linkConfig_t cfg;
+
+    cfg.delay                          = 0;
+    cfg.jitter                         = 0;
+    cfg.loss_model                     = LOSS_NONE;
+    cfg.loss                           = 0.0;
+    cfg.ge_p                           = 0.0;
+    cfg.ge_r                           = 1.0;
+    cfg.ge_loss_good                   = 0.0;
+    cfg.ge_loss_bad                    = 1.0;
+    cfg.reorder                        = 0.0;
+    cfg.reorder_delay                  = 0;
+    cfg.duplicate                      = 0.0;
+
+    return cfg;
+}
+
+// --------------------------------------------------
+// Configure a direction
+// --------------------------------------------------
+
+bool udpLinkModel::setConfig (uint32_t dir, const linkConfig_t &cfg)
+{
+    if (dir >= NUM_DIRS)
+    {
+        printf("udpLinkModel::setConfig() : ***ERROR. Invalid direction (%d)\n", dir);
+        return false;
+    }
+
+    if (cfg.loss_model > LOSS_GILBERT_ELLIOTT)
+    {
+        printf("udpLinkModel::setConfig() : ***ERROR. Invalid loss model (%d)\n", cfg.loss_model);
+        return false;
+    }
+
+    config[dir]                        = cfg;
+    ge_bad[dir]                        = false;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Loss decision for the next frame in a direction
+// --------------------------------------------------
+
+bool udpLinkModel::lose (uint32_t dir)
+{
+    linkConfig_t &cfg                  = config[dir];
+
+    if (cfg.loss_model == LOSS_BERNOULLI)
+    {
+        return randUniform() < cfg.loss;
+    }
+
+    if (cfg.loss_model == LOSS_GILBERT_ELLIOTT)
+    {
+        // Make the state transition for this frame, then apply the state's loss
+        if (ge_bad[dir])
+        {
+            ge_bad[dir]                = !(randUniform() < cfg.ge_r);
+        }
+        else if (randUniform() < cfg.ge_p)
+        {
+            ge_bad[dir]                = true;
+            stats[dir].bad_periods++;
+        }
+
+        return randUniform() < (ge_bad[dir] ? cfg.ge_loss_bad : cfg.ge_loss_good);
+    }
+
+    return false;
+}
+
+// --------------------------------------------------
+// Add a delivery to the timing wheel. The wheel
+// follows the caller's time, so only a delivery due
+// before the next tick to be processed (i.e. already
+// in the past) is moved up to it.
+// --------------------------------------------------
+
+void udpLinkModel::schedule (uint64_t due, uint32_t dir, uint32_t slot)
+{
+    if (due < wheel_tick)
+    {
+        due                            = wheel_tick;
+    }
+
+    wheel[due & (WHEEL_SLOTS-1)].push_back({due, dir, slot});
+    num_pending++;
+}
+
+// --------------------------------------------------
+// Pass a frame into the link
+// --------------------------------------------------
+
+bool udpLinkModel::send (uint32_t dir, const uint8_t* frame, uint32_t len, uint64_t now)
+{
+    if (dir >= NUM_DIRS || len > MAX_FRAME_LEN)
+    {
+        printf("udpLinkModel::send() : ***ERROR. Invalid direction (%d) or frame length (%d)\n", dir, len);
+        return false;
+    }
+
+    linkConfig_t &cfg                  = config[dir];
+    linkStats_t  &st                   = stats[dir];
+
+    st.frames_in++;
+
+    if (lose(dir))
+    {
+        st.lost++;
+        return false;
+    }
+
+    if (free_slots.empty())
+    {
+        st.overflow++;
+        return false;
+    }
+
+    // With nothing pending, the wheel restarts at the current time, and not at the
+    // delivery tick, as a later frame (e.g. in the other direction) may be due sooner.
+    // It is left alone when sending from the delivery callback, as advance() is still
+    // working through it.
+    if (num_pending == 0 && !advancing)
+    {
+        wheel_tick                     = now;
+    }
+
+    uint32_t slot                      = free_slots.back();
+    free_slots.pop_back();
+
+    memcpy(&pool[(size_t)slot * MAX_FRAME_LEN], frame, len);
+    frame_info[slot].len               = len;
+    frame_info[slot].refs              = 1;
+
+    // Delay with jitter, kept in order with earlier frames
+    uint64_t due                       = now + cfg.delay;
+
+    if (cfg.jitter)
+    {
+        due                            += rand64() % ((uint64_t)cfg.jitter + 1);
+    }
+
+    due                                = (due > last_due[dir]) ? due : last_due[dir];
+
+    // A held back frame does not hold back the frames after it
+    if (cfg.reorder > 0.0 && randUniform() < cfg.reorder)
+    {
+        st.reordered++;
+        due                            += cfg.reorder_delay;
+    }
+    else
+    {
+        last_due[dir]                  = due;
+    }
+
+    schedule(due, dir, slot);
+
+    // A duplicate follows the original
+    if (cfg.duplicate > 0.0 && randUniform() < cfg.duplicate)
+    {
+        st.duplicated++;
+        frame_info[slot].refs++;
+        schedule(due, dir, slot);
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Deliver frames due by tick now
+// --------------------------------------------------
+
+void udpLinkModel::advance (uint64_t now)
+{
+    std::vector<event_t> bucket;
+    std::vector<event_t> later;
+
+    if (num_pending == 0)
+    {
+        wheel_tick                     = now;
+        return;
+    }
+
+    advancing                          = true;
+
+    while (num_pending && wheel_tick <= now)
+    {
+        std::vector<event_t> &events   = wheel[wheel_tick & (WHEEL_SLOTS-1)];
+        bool                 delivered = true;
+
+        // Take the slot's events, so that the callback may send more frames. A frame
+        // it sends may be due on this tick, and so go back in this slot, which is
+        // taken again until nothing more is delivered.
+        while (delivered)
+        {
+            delivered                  = false;
+
+            bucket.clear();
+            bucket.swap(events);
+
+            for (uint32_t idx = 0; idx < bucket.size(); idx++)
+            {
+                event_t &e             = bucket[idx];
+
+                // Events for a later revolution go back on the wheel once the slot is done
+                if (e.due > wheel_tick)
+                {
+                    later.push_back(e);
+                    continue;
+                }
+
+                delivered              = true;
+                num_pending--;
+                stats[e.dir].frames_out++;
+
+                if (pDeliverFunc != NULL)
+                {
+                    (*pDeliverFunc)(e.dir, &pool[(size_t)e.slot * MAX_FRAME_LEN], frame_info[e.slot].len, hdl);
+                }
+
+                if (--frame_info[e.slot].refs == 0)
+                {
+                    free_slots.push_back(e.slot);
+                }
+            }
+        }
+
+        events.insert(events.end(), later.begin(), later.end());
+        later.clear();
+
+        wheel_tick++;
+    }
+
+    advancing                          = false;
+}
+
+// --------------------------------------------------
+// Print the statistics for both directions
+// --------------------------------------------------
+
+void udpLinkModel::printStats (FILE* fp)
+{
+    static const char* names[NUM_DIRS] = {"A->B", "B->A"};
+
+    for (uint32_t dir = 0; dir < NUM_DIRS; dir++)
+    {
+        linkStats_t &s                 = stats[dir];
+
+        fprintf(fp, "Link %s: in %" PRIu64 ", out %" PRIu64 ", lost %" PRIu64 ", duplicated %" PRIu64
+                    ", reordered %" PRIu64 ", overflow %" PRIu64 ", bad periods %" PRIu64 "\n",
+                names[dir], s.frames_in, s.frames_out, s.lost, s.duplicated, s.reordered, s.overflow, s.bad_periods);
+    }
+}
+
+// --------------------------------------------------
+// Random number generation (xorshift64*)
+// --------------------------------------------------
+
+uint64_t udpLinkModel::rand64 (void)
+{
+    state                              ^= state >> 12;
+    state                              ^= state << 25;
+    state                              ^= state >> 27;
+
+    return state * 0x2545f4914f6cdd1dULL;
+}
@@ -0,0 +1,207 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for a link impairment model between two nodes
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_LINK_MODEL_H_
+#define _UDP_LINK_MODEL_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+// -------------------------------------------------------------
+// Frame level model of an impaired link, with the two
+// directions (A to B and B to A) configured independently. Each
+// frame passed to send() is subject to loss (Bernoulli, or
+// Gilbert-Elliott two state bursty loss), duplication and
+// reordering, and is delivered to the registered callback once
+// the link delay, plus a random jitter, has passed. Jitter
+// alone does not reorder frames: a frame is never delivered
+// before an earlier frame in the same direction unless it was
+// picked for reordering, which holds it back by reorder_delay.
+//
+// The model has no VProc dependency. Time is in ticks passed in
+// by the caller to send() and advance(), so it can run against
+// a node's tick counter, a simulator-free backend, or wall
+// clock time (see tools/udpLinkBridge.cpp). Frames are held in
+// a fixed pool, and scheduled on a timing wheel, so that the
+// cost per frame is constant at high frame rates. Random
+// choices are made with a seeded generator, so a run is
+// repeatable for a given seed and traffic.
+// -------------------------------------------------------------
+
+class udpLinkModel
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Link directions
+    static const uint32_t DIR_A_TO_B           = 0;
+    static const uint32_t DIR_B_TO_A           = 1;
+    static const uint32_t NUM_DIRS             = 2;
+
+    // Loss models
+    static const uint32_t LOSS_NONE            = 0;
+    static const uint32_t LOSS_BERNOULLI       = 1;
+    static const uint32_t LOSS_GILBERT_ELLIOTT = 2;
+
+    // Largest frame (with an 802.1Q tag and FCS), and default pool size
+    static const uint32_t MAX_FRAME_LEN        = 1522; // BYTES
+    static const uint32_t DEFAULT_POOL_FRAMES  = 4096;
+
+    // Timing wheel slots (power of 2). Delays longer than this are allowed, but take
+    // more than one revolution.
+    static const uint32_t WHEEL_SLOTS          = 4096;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Per direction impairments. Probabilities are 0.0 to 1.0.
+    typedef struct {
+        uint32_t          delay;         // Fixed delay (ticks)
+        uint32_t          jitter;        // Maximum extra random delay (ticks)
+        uint32_t          loss_model;    // LOSS_xxx
+        double            loss;          // Bernoulli loss probability
+        double            ge_p;          // Gilbert-Elliott good to bad transition probability
+        double            ge_r;          // Gilbert-Elliott bad to good transition probability
+        double            ge_loss_good;  // Gilbert-Elliott loss probability in the good state
+        double            ge_loss_bad;   // Gilbert-Elliott loss probability in the bad state
+        double            reorder;       // Probability a frame is held back
+        uint32_t          reorder_delay; // Extra delay of a held back frame (ticks)
+        double            duplicate;     // Probability a frame is delivered twice
+    } linkConfig_t;
+
+    typedef struct {
+        uint64_t          frames_in;     // Frames passed to send()
+        uint64_t          frames_out;    // Frames delivered, including duplicates
+        uint64_t          lost;          // Frames dropped by the loss model
+        uint64_t          duplicated;    // Extra copies delivered
+        uint64_t          reordered;     // Frames held back for reordering
+        uint64_t          overflow;      // Frames dropped because the pool was full
+        uint64_t          bad_periods;   // Gilbert-Elliott good to bad transitions
+    } linkStats_t;
+
+    // Callback for delivered frames
+    typedef void (*pDeliverFunc_t) (uint32_t dir, const uint8_t* frame, uint32_t len, void* hdl);
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpLinkModel (uint64_t seed = 1, uint32_t pool_frames = DEFAULT_POOL_FRAMES);
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to configure a direction's impairments. Returns false on error.
+    bool           setConfig           (uint32_t dir, const linkConfig_t &cfg);
+
+    // Method to return a configuration with no impairments
+    static linkConfig_t idealConfig    (void);
+
+    // Method to register the callback for delivered frames
+    void           registerDeliverCb   (pDeliverFunc_t pFunc, void* hdlIn) {pDeliverFunc = pFunc; hdl = hdlIn;};
+
+    // Method to pass a frame into the link at tick now. Returns false if the frame
+    // will not be delivered (lost, or the pool is full).
+    bool           send                (uint32_t dir, const uint8_t* frame, uint32_t len, uint64_t now);
+
+    // Method to deliver all frames due by tick now, in order of due tick
+    void           advance             (uint64_t now);
+
+    // Number of frames waiting for delivery
+    uint32_t       pending             (void) {return num_pending;};
+
+    // Statistics access
+    linkStats_t&   getStats            (uint32_t dir) {return stats[dir % NUM_DIRS];};
+    void           printStats          (FILE* fp = stdout);
+
+private:
+
+    // --------------------------------------------
+    // Private types
+    // --------------------------------------------
+
+    // A scheduled delivery
+    typedef struct {
+        uint64_t          due;
+        uint32_t          dir;
+        uint32_t          slot;          // Frame pool slot
+    } event_t;
+
+    // A pooled frame, shared by its duplicates
+    typedef struct {
+        uint32_t          len;
+        uint32_t          refs;
+    } frameInfo_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to decide whether the next frame in a direction is lost
+    bool           lose                (uint32_t dir);
+
+    // Method to add a delivery to the wheel
+    void           schedule            (uint64_t due, uint32_t dir, uint32_t slot);
+
+    // Random number generation (xorshift64*), and a uniform value in [0, 1)
+    uint64_t       rand64              (void);
+    double         randUniform         (void) {return (double)(rand64() >> 11) * (1.0 / 9007199254740992.0);};
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Configuration, statistics, Gilbert-Elliott state, and last scheduled delivery,
+    // per direction
+    linkConfig_t   config[NUM_DIRS];
+    linkStats_t    stats[NUM_DIRS];
+    bool           ge_bad[NUM_DIRS];
+    uint64_t       last_due[NUM_DIRS];
+
+    // Frame pool, its free list, and frame information
+    std::vector<uint8_t>     pool;
+    std::vector<uint32_t>    free_slots;
+    std::vector<frameInfo_t> frame_info;
+
+    // Timing wheel, the next tick to process, events waiting, and whether advance()
+    // is delivering
+    std::vector<std::vector<event_t> > wheel;
+    uint64_t       wheel_tick;
+    uint32_t       num_pending;
+    bool           advancing;
+
+    // Random generator state
+    uint64_t       state;
+
+    // Delivery callback, and its handle
+    pDeliverFunc_t pDeliverFunc;
+    void*          hdl;
+};
+
+#endif
@@ -0,0 +1,532 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for buffered, asynchronous logging
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifndef UDP_LOG_NO_VPROC
+extern "C" {
+#include "VUser.h"
+}
+#else
+#define VPrint printf
+#endif
+
+#include "udpLog.h"
+
+// Binary trace file identifier and record types
+static const char     BIN_MAGIC[8]     = {'U', 'D', 'P', 'L', 'O', 'G', '1', '\n'};
+static const uint8_t  BIN_REC_FMT      = 'F';
+static const uint8_t  BIN_REC_ENTRY    = 'E';
+
+// Size of text output file buffer
+static const uint32_t TEXT_BUF_SIZE    = 1024*1024;
+
+// Level names for decoded output prefix
+static const char*    level_names[]    = {"NONE", "ERROR", "WARNING", "INFO", "DEBUG"};
+
+// --------------------------------------------------
+// Constructor and destructor
+// --------------------------------------------------
+
+udpLog::udpLog() : running(false), stopping(false), dropped(0)
+{
+    log_level                          = LOG_INFO;
+    drop_on_full                       = false;
+    textfp                             = NULL;
+    binfp                              = NULL;
+
+    for (uint32_t idx = 0; idx < MAX_NODES; idx++)
+    {
+        rings[idx]                     = NULL;
+    }
+}
+
+udpLog::~udpLog()
+{
+    stop();
+
+    for (uint32_t idx = 0; idx < MAX_NODES; idx++)
+    {
+        delete rings[idx].load();
+    }
+}
+
+// --------------------------------------------------
+// Return the logger instance
+// --------------------------------------------------
+
+udpLog& udpLog::instance()
+{
+    static udpLog inst;
+
+    return inst;
+}
+
+// --------------------------------------------------
+// Capture a string argument, copying it into the
+// entry (truncated if out of space)
+// --------------------------------------------------
+
+void udpLog::capture (logEntry_t &e, const char* s)
+{
+    uint32_t room                      = MAX_STR_BYTES - e.strbytes;
+
+    if (room == 0)
+    {
+        addArg(e, ARG_STR, MAX_STR_BYTES - 1);
+        return;
+    }
+
+    uint32_t len                       = (s == NULL) ? 0 : strlen(s);
+    len                                = (len > room - 1) ? room - 1 : len;
+
+    if (len)
+    {
+        memcpy(&e.strs[e.strbytes], s, len);
+    }
+    e.strs[e.strbytes + len]           = 0;
+
+    addArg(e, ARG_STR, e.strbytes);
+    e.strbytes                         += len + 1;
+}
+
+// --------------------------------------------------
+// Format a captured message. Each conversion
+// specification has its length modifier replaced
+// to match the captured argument's type, so that
+// any printf style format can be used.
+// --------------------------------------------------
+
+uint32_t udpLog::format (const logEntry_t &e, char* buf, uint32_t len)
+{
+    uint32_t    oidx                   = 0;
+    uint32_t    aidx                   = 0;
+    const char* p                      = e.fmt;
+
+    while (*p && oidx < len - 1)
+    {
+        if (*p != '%')
+        {
+            buf[oidx++]                = *p++;
+            continue;
+        }
+
+        if (p[1] == '%')
+        {
+            buf[oidx++]                = '%';
+            p                          += 2;
+            continue;
+        }
+
+        // Collect the flags, width and precision, and skip any length modifier
+        char spec[32];
+        int  sidx                      = 0;
+
+        spec[sidx++]                   = *p++;
+        while (*p && strchr("-+ #0123456789.", *p) && sidx < 24)
+        {
+            spec[sidx++]               = *p++;
+        }
+        while (*p && strchr("hlLqjzt", *p))
+        {
+            p++;
+        }
+
+        char conv                      = *p;
+        if (conv == 0)
+        {
+            break;
+        }
+        p++;
+
+        size_t   room                  = len - oidx;
+        int      n                     = 0;
+
+        if (aidx >= e.nargs)
+        {
+            n                          = snprintf(&buf[oidx], room, "<?>");
+        }
+        else
+        {
+            uint8_t  type              = e.types[aidx];
+            uint64_t val               = e.args[aidx++];
+            double   dval;
+
+            if (type == ARG_DOUBLE)
+            {
+                memcpy(&dval, &val, sizeof(dval));
+            }
+            else
+            {
+                dval                   = (type == ARG_INT) ? (double)(int64_t)val : (double)val;
+            }
+
+            switch (conv)
+            {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+                spec[sidx++]           = 'l';
+                spec[sidx++]           = 'l';
+                spec[sidx++]           = conv;
+                spec[sidx]             = 0;
+                val                    = (type == ARG_DOUBLE) ? (uint64_t)(int64_t)dval : val;
+                n                      = (conv == 'd' || conv == 'i') ? snprintf(&buf[oidx], room, spec, (long long)val) :
+                                                                        snprintf(&buf[oidx], room, spec, (unsigned long long)val);
+                break;
+
+            case 'c':
+                spec[sidx++]           = conv;
+                spec[sidx]             = 0;
+                n                      = snprintf(&buf[oidx], room, spec, (int)val);
+                break;
+
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                spec[sidx++]           = conv;
+                spec[sidx]             = 0;
+                n                      = snprintf(&buf[oidx], room, spec, dval);
+                break;
+
+            case 's':
+                spec[sidx++]           = conv;
+                spec[sidx]             = 0;
+                n                      = snprintf(&buf[oidx], room, spec, (type == ARG_STR) ? &e.strs[val % MAX_STR_BYTES] : "<?>");
+                break;
+
+            case 'p':
+                spec[sidx++]           = conv;
+                spec[sidx]             = 0;
+                n                      = snprintf(&buf[oidx], room, spec, (void*)(uintptr_t)val);
+                break;
+
+            default:
+                n                      = snprintf(&buf[oidx], room, "<?>");
+                break;
+            }
+        }
+
+        if (n > 0)
+        {
+            oidx                       += ((size_t)n < room) ? n : room - 1;
+        }
+    }
+
+    buf[oidx]                          = 0;
+
+    return oidx;
+}
+
+// --------------------------------------------------
+// Start asynchronous logging
+// --------------------------------------------------
+
+bool udpLog::start (const char* textfile, const char* binfile, bool text)
+{
+    if (running)
+    {
+        printf("udpLog::start() : ***ERROR. Logging already started\n");
+        return false;
+    }
+
+    textfp                             = NULL;
+    binfp                              = NULL;
+
+    if (text)
+    {
+        textfp                         = (textfile == NULL) ? stdout : fopen(textfile, "w");
+
+        if (textfp == NULL)
+        {
+            printf("udpLog::start() : ***ERROR. Unable to open %s for writing\n", textfile);
+            return false;
+        }
+
+        if (textfp != stdout)
+        {
+            setvbuf(textfp, NULL, _IOFBF, TEXT_BUF_SIZE);
+        }
+    }
+
+    if (binfile != NULL)
+    {
+        if ((binfp = fopen(binfile, "wb")) == NULL)
+        {
+            printf("udpLog::start() : ***ERROR. Unable to open %s for writing\n", binfile);
+            return false;
+        }
+
+        setvbuf(binfp, NULL, _IOFBF, TEXT_BUF_SIZE);
+        fwrite(BIN_MAGIC, 1, sizeof(BIN_MAGIC), binfp);
+        fmt_ids.clear();
+    }
+
+    stopping                           = false;
+    running                            = true;
+
+    thread                             = std::thread(&udpLog::consumer, this);
+
+    return true;
+}
+
+// --------------------------------------------------
+// Drain all messages and stop the background thread
+// --------------------------------------------------
+
+void udpLog::stop (void)
+{
+    if (!running)
+    {
+        return;
+    }
+
+    stopping                           = true;
+    thread.join();
+    running                            = false;
+
+    if (textfp != NULL)
+    {
+        fflush(textfp);
+        if (textfp != stdout)
+        {
+            fclose(textfp);
+        }
+        textfp                         = NULL;
+    }
+
+    if (binfp != NULL)
+    {
+        fclose(binfp);
+        binfp                          = NULL;
+    }
+}
+
+// --------------------------------------------------
+// Pass a captured message to the node's ring, or
+// print immediately if not started
+// --------------------------------------------------
+
+void udpLog::submit (logEntry_t &e)
+{
+    if (!running || e.node >= MAX_NODES)
+    {
+        char line[MAX_LINE_LEN];
+        format(e, line, MAX_LINE_LEN);
+        VPrint("%s", line);
+        return;
+    }
+
+    logRing_t* ring                    = rings[e.node].load(std::memory_order_acquire);
+
+    if (ring == NULL)
+    {
+        ring                           = new logRing_t;
+        rings[e.node].store(ring, std::memory_order_release);
+    }
+
+    while (!ring->push(e))
+    {
+        if (drop_on_full)
+        {
+            dropped++;
+            return;
+        }
+        std::this_thread::yield();
+    }
+}
+
+// --------------------------------------------------
+// Background thread. Drains all the node rings, and
+// sleeps briefly when there is nothing to do.
+// --------------------------------------------------
+
+void udpLog::consumer (void)
+{
+    while (true)
+    {
+        bool progress                  = false;
+
+        for (uint32_t node = 0; node < MAX_NODES; node++)
+        {
+            logRing_t*  ring           = rings[node].load(std::memory_order_acquire);
+            logEntry_t* e;
+
+            while (ring != NULL && (e = ring->front()) != NULL)
+            {
+                output(*e);
+                ring->release();
+                progress               = true;
+            }
+        }
+
+        if (!progress)
+        {
+            // Only finish after a pass that found nothing after stop was requested
+            if (stopping)
+            {
+                break;
+            }
+
+            // Flush when idle, so output is not lost if the simulation terminates abruptly
+            if (textfp != NULL) fflush(textfp);
+            if (binfp  != NULL) fflush(binfp);
+
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+// --------------------------------------------------
+// Output a message as text and/or binary
+// --------------------------------------------------
+
+void udpLog::output (const logEntry_t &e)
+{
+    if (textfp != NULL)
+    {
+        char     line[MAX_LINE_LEN];
+        uint32_t len                   = format(e, line, MAX_LINE_LEN);
+        fwrite(line, 1, len, textfp);
+    }
+
+    if (binfp != NULL)
+    {
+        // Define a new format string on first use
+        auto     it                    = fmt_ids.find(e.fmt);
+        uint32_t id;
+
+        if (it == fmt_ids.end())
+        {
+            id                         = fmt_ids.size();
+            fmt_ids[e.fmt]             = id;
+
+            uint16_t len               = strlen(e.fmt);
+            fwrite(&BIN_REC_FMT, 1, 1, binfp);
+            fwrite(&id,          sizeof(id),  1, binfp);
+            fwrite(&len,         sizeof(len), 1, binfp);
+            fwrite(e.fmt,        1, len, binfp);
+        }
+        else
+        {
+            id                         = it->second;
+        }
+
+        fwrite(&BIN_REC_ENTRY, 1, 1, binfp);
+        fwrite(&id,            sizeof(id),     1, binfp);
+        fwrite(&e.tick,        sizeof(e.tick), 1, binfp);
+        fwrite(&e.node,        1, 1, binfp);
+        fwrite(&e.level,       1, 1, binfp);
+        fwrite(&e.nargs,       1, 1, binfp);
+        fwrite(&e.strbytes,    1, 1, binfp);
+        fwrite(e.types,        1, e.nargs, binfp);
+        fwrite(e.args,         sizeof(uint64_t), e.nargs, binfp);
+        fwrite(e.strs,         1, e.strbytes, binfp);
+    }
+}
+
+// --------------------------------------------------
+// Decode a binary trace to text
+// --------------------------------------------------
+
+int udpLog::decode (FILE* in, FILE* out, bool prefix)
+{
+    char                     magic[sizeof(BIN_MAGIC)];
+    std::vector<std::string> fmts;
+    int                      count     = 0;
+
+    if (fread(magic, 1, sizeof(magic), in) != sizeof(magic) || memcmp(magic, BIN_MAGIC, sizeof(magic)))
+    {
+        fprintf(stderr, "udpLog::decode() : ***ERROR. Not a udpLog binary trace\n");
+        return -1;
+    }
+
+    uint8_t rec;
+
+    while (fread(&rec, 1, 1, in) == 1)
+    {
+        uint32_t id;
+
+        if (fread(&id, sizeof(id), 1, in) != 1)
+        {
+            break;
+        }
+
+        if (rec == BIN_REC_FMT)
+        {
+            uint16_t    len;
+            std::string fmt;
+
+            if (fread(&len, sizeof(len), 1, in) != 1)
+            {
+                break;
+            }
+
+            fmt.resize(len);
+            if (len && fread(&fmt[0], 1, len, in) != len)
+            {
+                break;
+            }
+
+            if (id >= fmts.size())
+            {
+                fmts.resize(id + 1);
+            }
+            fmts[id]                   = fmt;
+        }
+        else if (rec == BIN_REC_ENTRY)
+        {
+            logEntry_t e;
+
+            if (fread(&e.tick,  sizeof(e.tick), 1, in) != 1 ||
+                fread(&e.node,  1, 1, in) != 1 || fread(&e.level,    1, 1, in) != 1 ||
+                fread(&e.nargs, 1, 1, in) != 1 || fread(&e.strbytes, 1, 1, in) != 1 ||
+                e.nargs > MAX_ARGS || e.strbytes > MAX_STR_BYTES ||
+                fread(e.types, 1, e.nargs, in) != e.nargs ||
+                fread(e.args,  sizeof(uint64_t), e.nargs, in) != e.nargs ||
+                fread(e.strs,  1, e.strbytes, in) != e.strbytes ||
+                id >= fmts.size())
+            {
+                fprintf(stderr, "udpLog::decode() : ***ERROR. Corrupt trace record\n");
+                return -1;
+            }
+
+            char line[MAX_LINE_LEN];
+
+            e.fmt                      = fmts[id].c_str();
+            format(e, line, MAX_LINE_LEN);
+
+            if (prefix)
+            {
+                fprintf(out, "[%10u] NODE%d %-7s: ", e.tick, e.node, level_names[e.level <= LOG_DEBUG ? e.level : 0]);
+            }
+            fputs(line, out);
+            count++;
+        }
+        else
+        {
+            fprintf(stderr, "udpLog::decode() : ***ERROR. Unknown record type (0x%02x)\n", rec);
+            return -1;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,232 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for buffered, asynchronous logging
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_LOG_H_
+#define _UDP_LOG_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+
+#include "udpSpscRing.h"
+
+// -------------------------------------------------------------
+// Logging with levels. A log call only captures the format
+// string pointer and the raw argument values into a per-node
+// ring buffer, and a background thread does the formatting and
+// file writes. Optionally, the background thread writes a
+// compact binary trace instead of, or as well as, text, which
+// can be decoded offline with udpLog::decode() (see
+// tools/udpLogDecode.cpp).
+//
+// Until start() is called, messages are formatted and printed
+// immediately with VPrint, in the calling thread.
+//
+// Each node's ring must only be written by that node's VProc
+// thread. Format strings must be string literals (or otherwise
+// outlive the logger), and %s arguments are copied.
+// -------------------------------------------------------------
+
+class udpLog
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Log levels
+    static const uint32_t LOG_NONE             = 0;
+    static const uint32_t LOG_ERROR            = 1;
+    static const uint32_t LOG_WARNING          = 2;
+    static const uint32_t LOG_INFO             = 3;
+    static const uint32_t LOG_DEBUG            = 4;
+
+    // Buffer dimensions
+    static const uint32_t MAX_NODES            = 16;
+    static const uint32_t RING_ENTRIES         = 4096;
+    static const uint32_t MAX_ARGS             = 16;
+    static const uint32_t MAX_STR_BYTES        = 128;
+    static const uint32_t MAX_LINE_LEN         = 2048;
+
+    // Argument types
+    static const uint8_t  ARG_INT              = 0;
+    static const uint8_t  ARG_UINT             = 1;
+    static const uint8_t  ARG_DOUBLE           = 2;
+    static const uint8_t  ARG_STR              = 3;
+    static const uint8_t  ARG_PTR              = 4;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // A captured log message
+    typedef struct {
+        const char*       fmt;
+        uint32_t          tick;
+        uint8_t           node;
+        uint8_t           level;
+        uint8_t           nargs;
+        uint8_t           strbytes;
+        uint8_t           types[MAX_ARGS];
+        uint64_t          args[MAX_ARGS];   // Doubles stored bitwise, strings as offsets into strs
+        char              strs[MAX_STR_BYTES];
+    } logEntry_t;
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to return the logger instance
+    static udpLog& instance();
+
+    // Level control
+    void           setLevel            (uint32_t level) {log_level = level;};
+    uint32_t       getLevel            (void)           {return log_level;};
+    bool           enabled             (uint32_t level) {return level != LOG_NONE && level <= log_level;};
+
+    // Method to start asynchronous logging. Text goes to textfile (stdout if NULL),
+    // unless text is false, and a binary trace to binfile, if not NULL.
+    bool           start               (const char* textfile = NULL, const char* binfile = NULL, bool text = true);
+
+    // Method to drain all buffered messages and stop the background thread
+    void           stop                (void);
+
+    // Control of behaviour when a node's ring is full: drop (and count) the message, or wait
+    void           setDropOnFull       (bool drop) {drop_on_full = drop;};
+    uint64_t       getDropped          (void)      {return dropped;};
+
+    // Method to log a message for a node at a given tick
+    template<typename... Args>
+    void           log                 (uint32_t node, uint32_t tick, uint32_t level, const char* fmt, Args... args)
+    {
+        if (!enabled(level))
+        {
+            return;
+        }
+
+        logEntry_t e;
+        e.fmt                          = fmt;
+        e.tick                         = tick;
+        e.node                         = node;
+        e.level                        = level;
+        e.nargs                        = 0;
+        e.strbytes                     = 0;
+
+        int dummy[]                    = {0, (capture(e, args), 0)...};
+        (void)dummy;
+
+        submit(e);
+    }
+
+    // Method to format a captured message as text, returning its length
+    static uint32_t format             (const logEntry_t &e, char* buf, uint32_t len);
+
+    // Method to decode a binary trace to text, with optional tick/node/level prefix.
+    // Returns the number of messages, or -1 on error.
+    static int     decode              (FILE* in, FILE* out, bool prefix = true);
+
+private:
+
+    // --------------------------------------------
+    // Private type definitions
+    // --------------------------------------------
+
+    typedef udpSpscRing<logEntry_t, RING_ENTRIES> logRing_t;
+
+    // --------------------------------------------
+    // Constructor/destructor (singleton)
+    // --------------------------------------------
+
+    udpLog  ();
+    ~udpLog ();
+
+    udpLog(const udpLog&)            = delete;
+    udpLog& operator=(const udpLog&) = delete;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Argument capture
+    static void    addArg              (logEntry_t &e, uint8_t type, uint64_t val)
+                                       {if (e.nargs < MAX_ARGS) {e.types[e.nargs] = type; e.args[e.nargs++] = val;}};
+
+    template<typename T>
+    static typename std::enable_if<std::is_integral<T>::value>::type
+                   capture             (logEntry_t &e, T v)
+                                       {addArg(e, std::is_signed<T>::value ? ARG_INT : ARG_UINT,
+                                               std::is_signed<T>::value ? (uint64_t)(int64_t)v : (uint64_t)v);};
+
+    template<typename T>
+    static typename std::enable_if<std::is_floating_point<T>::value>::type
+                   capture             (logEntry_t &e, T v)
+                                       {double d = v; uint64_t u; memcpy(&u, &d, sizeof(u)); addArg(e, ARG_DOUBLE, u);};
+
+    template<typename T>
+    static void    capture             (logEntry_t &e, T* p) {addArg(e, ARG_PTR, (uint64_t)(uintptr_t)p);};
+
+    static void    capture             (logEntry_t &e, char* s)       {capture(e, (const char*)s);};
+    static void    capture             (logEntry_t &e, const char* s);
+
+    // Method to pass a captured message to the background thread, or print it
+    void           submit              (logEntry_t &e);
+
+    // Background thread main loop, and output of a message from it
+    void           consumer            (void);
+    void           output              (const logEntry_t &e);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Current log level
+    uint32_t                           log_level;
+
+    // Per-node rings, allocated on first use by the node
+    std::atomic<logRing_t*>            rings[MAX_NODES];
+
+    // Background thread and its state
+    std::thread                        thread;
+    std::atomic<bool>                  running;
+    std::atomic<bool>                  stopping;
+
+    // Full ring behaviour and dropped message count
+    bool                               drop_on_full;
+    std::atomic<uint64_t>              dropped;
+
+    // Output files, and format string IDs assigned in the binary trace
+    FILE*                              textfp;
+    FILE*                              binfp;
+    std::unordered_map<const char*, uint32_t> fmt_ids;
+};
+
+// Convenience macro, avoiding argument evaluation when the level is disabled
+#define UDP_LOG(_node, _tick, _level, ...) \
+    do {if (udpLog::instance().enabled(_level)) udpLog::instance().log(_node, _tick, _level, __VA_ARGS__);} while(0)
+
+#endif
@@ -0,0 +1,278 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for UDP payload pattern generation
+// and checking
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cstring>
+#include <cinttypes>
+
+extern "C" {
+#include "VUser.h"
+}
+
+#include "udpPayload.h"
+
+// PRBS polynomial x^n + x^m + 1 parameters (ITU-T O.150), indexed by pattern type
+static const uint32_t prbs_n[] = {7, 15, 23, 31};
+static const uint32_t prbs_m[] = {6, 14, 18, 28};
+
+// --------------------------------------------------
+// Configure the generator
+// --------------------------------------------------
+
+void udpPayload::setPattern (uint32_t patternIn, uint32_t flowIn, uint32_t seedIn)
+{
+    if (patternIn >= NUM_PATTERNS)
+    {
+        printf("udpPayload::setPattern() : ***ERROR. Invalid pattern type (%d). Using PRBS31\n", patternIn);
+        patternIn                      = PRBS31;
+    }
+
+    pattern                            = patternIn;
+    flow                               = flowIn & 0xffff;
+    state                              = validState(pattern, seedIn);
+    seq                                = 0;
+}
+
+// --------------------------------------------------
+// Return a valid starting state. The PRBS states are
+// masked to the register width, and the all-zeros
+// lock-up state avoided.
+// --------------------------------------------------
+
+uint32_t udpPayload::validState (uint32_t pattern, uint32_t seed)
+{
+    if (pattern == COUNT)
+    {
+        return seed & 0xff;
+    }
+
+    uint32_t mask                      = (1U << prbs_n[pattern]) - 1;
+
+    return (seed & mask) ? (seed & mask) : mask;
+}
+
+// --------------------------------------------------
+// Generate pattern bytes. The PRBS registers are
+// Fibonacci LFSRs shifting left, with the feedback
+// bit as the output, MSB first in each byte. Since
+// the feedback taps are at least m bits from the
+// input, up to m bits can be generated at once.
+// --------------------------------------------------
+
+void udpPayload::genBytes (uint8_t* buf, uint32_t len, uint32_t pattern, uint32_t &state)
+{
+    if (pattern == COUNT)
+    {
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            buf[idx]                   = state;
+            state                      = (state + 1) & 0xff;
+        }
+        return;
+    }
+
+    uint32_t n                         = prbs_n[pattern];
+    uint32_t m                         = prbs_m[pattern];
+    uint32_t mask                      = (1U << n) - 1;
+    uint32_t s                         = state;
+
+    if (m >= 8)
+    {
+        // A whole byte per step
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            uint32_t fb                = ((s >> (n-8)) ^ (s >> (m-8))) & 0xff;
+            s                          = ((s << 8) | fb) & mask;
+            buf[idx]                   = fb;
+        }
+    }
+    else
+    {
+        // A nibble per step
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            uint32_t fbhi              = ((s >> (n-4)) ^ (s >> (m-4))) & 0xf;
+            s                          = ((s << 4) | fbhi) & mask;
+            uint32_t fblo              = ((s >> (n-4)) ^ (s >> (m-4))) & 0xf;
+            s                          = ((s << 4) | fblo) & mask;
+            buf[idx]                   = (fbhi << 4) | fblo;
+        }
+    }
+
+    state                              = s;
+}
+
+// --------------------------------------------------
+// Fill a payload buffer with a header and pattern
+// data. The buffer is one byte per word, as used by
+// udpIpPg::genUdpIpPkt().
+// --------------------------------------------------
+
+uint32_t udpPayload::fill (uint32_t* payload, uint32_t len)
+{
+    if (len < HDR_LEN || len > MAX_PAYLOAD_LEN)
+    {
+        printf("udpPayload::fill() : ***ERROR. Payload length (%d) must be between %d and %d\n", len, HDR_LEN, MAX_PAYLOAD_LEN);
+        return 0;
+    }
+
+    uint32_t pidx                      = 0;
+
+    // Add the header, with the state for the first data byte and the sequence number
+    payload[pidx++]                    = HDR_MAGIC;
+    payload[pidx++]                    = pattern;
+    payload[pidx++]                    = (flow  >>  8) & 0xff;
+    payload[pidx++]                    = flow          & 0xff;
+    payload[pidx++]                    = (state >> 24) & 0xff;
+    payload[pidx++]                    = (state >> 16) & 0xff;
+    payload[pidx++]                    = (state >>  8) & 0xff;
+    payload[pidx++]                    = state         & 0xff;
+    payload[pidx++]                    = (seq   >> 24) & 0xff;
+    payload[pidx++]                    = (seq   >> 16) & 0xff;
+    payload[pidx++]                    = (seq   >>  8) & 0xff;
+    payload[pidx++]                    = seq           & 0xff;
+
+    seq++;
+
+    // Generate the pattern data, continuing from the last payload
+    genBytes(genbuf, len - HDR_LEN, pattern, state);
+
+    for (uint32_t idx = 0; idx < len - HDR_LEN; idx++)
+    {
+        payload[pidx++]                = genbuf[idx];
+    }
+
+    return len;
+}
+
+// --------------------------------------------------
+// Check a received payload. The expected data is
+// regenerated from the header's state, and compared
+// 64 bits at a time, with the bit and byte error
+// counts for each word calculated in parallel.
+// Individual bytes are only examined on words with
+// errors.
+// --------------------------------------------------
+
+uint32_t udpPayload::check (const uint8_t* payload, uint32_t len)
+{
+    uint32_t byte_errors               = 0;
+
+    if (!isPatternPayload(payload, len) || len > MAX_PAYLOAD_LEN)
+    {
+        stats.bad_headers++;
+        return 0;
+    }
+
+    uint32_t rxpattern                 = payload[1];
+    uint32_t rxflow                    = (payload[2] << 8) | payload[3];
+    uint32_t rxstate                   = ((uint32_t)payload[4] << 24) | (payload[5] << 16) | (payload[6] << 8) | payload[7];
+
+    // Regenerate the expected data
+    uint32_t datalen                   = len - HDR_LEN;
+    const uint8_t* rxdata              = &payload[HDR_LEN];
+
+    rxstate                            = validState(rxpattern, rxstate);
+    genBytes(expbuf, datalen, rxpattern, rxstate);
+
+    for (uint32_t idx = 0; idx < datalen; idx += 8)
+    {
+        uint32_t chunk                 = (datalen - idx) < 8 ? (datalen - idx) : 8;
+        uint64_t rxword                = 0;
+        uint64_t expword               = 0;
+
+        memcpy(&rxword,  &rxdata[idx], chunk);
+        memcpy(&expword, &expbuf[idx], chunk);
+
+        uint64_t diff                  = rxword ^ expword;
+
+        if (diff)
+        {
+            // Fold each byte's bits into its LSB to count the errored bytes
+            uint64_t bytediff          = diff;
+            bytediff                   |= bytediff >> 4;
+            bytediff                   |= bytediff >> 2;
+            bytediff                   |= bytediff >> 1;
+            bytediff                   &= 0x0101010101010101ULL;
+
+            uint32_t word_byte_errors  = __builtin_popcountll(bytediff);
+
+            stats.bit_errors           += __builtin_popcountll(diff);
+            byte_errors                += word_byte_errors;
+
+            // Record the locations of errored bytes, up to the maximum
+            for (uint32_t bidx = 0; bidx < chunk && stats.num_err_locs < MAX_ERR_LOCS; bidx++)
+            {
+                if (rxdata[idx+bidx] != expbuf[idx+bidx])
+                {
+                    errLoc_t &loc      = stats.err_locs[stats.num_err_locs++];
+                    loc.flow           = rxflow;
+                    loc.pkt_num        = stats.pkts_checked;
+                    loc.offset         = HDR_LEN + idx + bidx;
+                    loc.got            = rxdata[idx+bidx];
+                    loc.exp            = expbuf[idx+bidx];
+                }
+            }
+        }
+    }
+
+    stats.pkts_checked++;
+    stats.bytes_checked                += datalen;
+    stats.byte_errors                  += byte_errors;
+
+    if (byte_errors)
+    {
+        stats.pkts_errored++;
+    }
+
+    return byte_errors;
+}
+
+// --------------------------------------------------
+// Clear the checker statistics
+// --------------------------------------------------
+
+void udpPayload::clearStats (void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+// --------------------------------------------------
+// Print out the checker statistics
+// --------------------------------------------------
+
+void udpPayload::printStats (int node)
+{
+    VPrint("Node%d: Payload packets checked....: %" PRIu64 " (%" PRIu64 " errored, %" PRIu64 " bad headers)\n",
+           node, stats.pkts_checked, stats.pkts_errored, stats.bad_headers);
+    VPrint("Node%d: Payload bytes checked......: %" PRIu64 "\n", node, stats.bytes_checked);
+    VPrint("Node%d: Payload byte errors........: %" PRIu64 "\n", node, stats.byte_errors);
+    VPrint("Node%d: Payload bit errors.........: %" PRIu64 "\n", node, stats.bit_errors);
+
+    for (uint32_t idx = 0; idx < stats.num_err_locs; idx++)
+    {
+        errLoc_t &loc = stats.err_locs[idx];
+        VPrint("Node%d:   flow %d packet %d offset %d: got 0x%02x exp 0x%02x\n",
+               node, loc.flow, loc.pkt_num, loc.offset, loc.got, loc.exp);
+    }
+}
@@ -0,0 +1,168 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for UDP payload pattern generation and checking
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_PAYLOAD_H_
+#define _UDP_PAYLOAD_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+// -------------------------------------------------------------
+// Payload pattern engine. Each generated payload starts with a
+// small header carrying the pattern type, a flow ID, the
+// pattern state for the first data byte, and a per-flow sequence
+// number, so that every payload can be checked in isolation,
+// regardless of any lost packets.
+//
+// Header format (bytes):
+//
+//   [0]    HDR_MAGIC
+//   [1]    Pattern type
+//   [2:3]  Flow ID (MSB first)
+//   [4:7]  Pattern state at first data byte (MSB first)
+//   [8:11] Sequence number (MSB first)
+//
+// -------------------------------------------------------------
+
+class udpPayload
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Pattern types
+    static const uint32_t PRBS7                = 0;
+    static const uint32_t PRBS15               = 1;
+    static const uint32_t PRBS23               = 2;
+    static const uint32_t PRBS31               = 3;
+    static const uint32_t COUNT                = 4;
+    static const uint32_t NUM_PATTERNS         = 5;
+
+    // Payload header parameters
+    static const uint32_t HDR_MAGIC            = 0xa5;
+    static const uint32_t HDR_LEN              = 12; // BYTES
+
+    // Maximum number of error locations recorded by the checker
+    static const uint32_t MAX_ERR_LOCS         = 16;
+
+    // Size of the checker's expected data buffer
+    static const uint32_t MAX_PAYLOAD_LEN      = 2048; // BYTES
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Location of a payload byte error
+    typedef struct {
+        uint32_t flow;
+        uint32_t pkt_num;
+        uint32_t offset;   // Byte offset into payload, including header
+        uint8_t  got;
+        uint8_t  exp;
+    } errLoc_t;
+
+    // Accumulated checker statistics
+    typedef struct {
+        uint64_t pkts_checked;
+        uint64_t pkts_errored;
+        uint64_t bad_headers;
+        uint64_t bytes_checked;
+        uint64_t byte_errors;
+        uint64_t bit_errors;
+        uint32_t num_err_locs;
+        errLoc_t err_locs[MAX_ERR_LOCS];
+    } chkStats_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpPayload  (uint32_t patternIn = PRBS31, uint32_t flowIn = 0, uint32_t seedIn = 1)
+    {
+        setPattern(patternIn, flowIn, seedIn);
+        clearStats();
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to (re)configure the generator pattern, flow ID and seed
+    void           setPattern          (uint32_t patternIn, uint32_t flowIn, uint32_t seedIn);
+
+    // Method to fill a payload buffer (one byte per word) with header and pattern data,
+    // continuing the pattern from the previous call. Returns the length in bytes.
+    uint32_t       fill                (uint32_t* payload, uint32_t len);
+
+    // Method to check a received payload, accumulating statistics. Returns number of byte errors.
+    uint32_t       check               (const uint8_t* payload, uint32_t len);
+
+    // Method to determine if a received payload looks like a pattern payload
+    static bool    isPatternPayload    (const uint8_t* payload, uint32_t len)
+                                       {return len >= HDR_LEN && payload[0] == HDR_MAGIC && payload[1] < NUM_PATTERNS;};
+
+    // Methods to extract the flow ID and sequence number from a pattern payload header
+    template<typename T>
+    static uint32_t getFlow            (const T* payload) {return ((payload[2] & 0xff) << 8) | (payload[3] & 0xff);};
+    template<typename T>
+    static uint32_t getSeq             (const T* payload) {return ((uint32_t)(payload[8]  & 0xff) << 24) | ((payload[9]  & 0xff) << 16) |
+                                                                  ((payload[10] & 0xff) <<  8) |  (payload[11] & 0xff);};
+
+    // Statistics access
+    void           clearStats          (void);
+    chkStats_t&    getStats            (void) {return stats;};
+    void           printStats          (int node);
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to generate len bytes of pattern into buf, updating state
+    static void    genBytes            (uint8_t* buf, uint32_t len, uint32_t pattern, uint32_t &state);
+
+    // Method to return a valid starting state for a pattern from a seed
+    static uint32_t validState         (uint32_t pattern, uint32_t seed);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Generator configuration and current pattern state
+    uint32_t       pattern;
+    uint32_t       flow;
+    uint32_t       state;
+    uint32_t       seq;
+
+    // Checker statistics
+    chkStats_t     stats;
+
+    // Scratch buffers for generated and expected data
+    uint8_t        genbuf[MAX_PAYLOAD_LEN];
+    uint8_t        expbuf[MAX_PAYLOAD_LEN];
+};
+
+#endif
@@ -0,0 +1,219 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Hot path profiling of a node's time split between VProc
+// accesses and its own C++ code. Compiled in with -DUDP_PROFILE,
+// and to nothing otherwise.
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_PROFILE_H_
+#define _UDP_PROFILE_H_
+
+#ifdef UDP_PROFILE
+
+#include <stdint.h>
+#include <cinttypes>
+#include <chrono>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "VUser.h"
+}
+
+// -------------------------------------------------------------
+// Each node's wall time is charged to exactly one category at a
+// time. A udpProfile::scope charges the time until it is
+// destroyed to its category, pausing the enclosing one, so that
+// nested scopes (e.g. a VProc access from a receive callback
+// within processFrame()) are not counted twice, and the
+// categories always sum to the wall time. PROF_VPROC covers the
+// time from calling VWrite()/VRead() to their return, which is
+// the simulator's run time plus the handoff between threads.
+// PROF_OTHER is any other time in the node's code.
+//
+// Times are taken from the TSC where available, calibrated
+// against steady_clock over the run, and steady_clock
+// otherwise. Each node has its own profile, updated only from
+// the thread that constructed it (the node's). Scopes entered
+// on other threads, such as udpFrameGen's producer calling
+// genUdpIpPkt(), are not timed, as that time is not the
+// node's.
+// -------------------------------------------------------------
+
+class udpProfile
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Time categories
+    static const uint32_t PROF_OTHER           = 0;
+    static const uint32_t PROF_VPROC           = 1;
+    static const uint32_t PROF_GEN             = 2;
+    static const uint32_t PROF_RX              = 3;
+    static const uint32_t NUM_PROF             = 4;
+
+    // --------------------------------------------
+    // Scope timer
+    // --------------------------------------------
+
+    class scope
+    {
+    public:
+        scope  (udpProfile &profIn, uint32_t cat) : prof(profIn), active(profIn.owned()) {if (active) saved = prof.enter(cat);};
+        ~scope ()                                                                   {if (active) prof.leave(saved);};
+
+    private:
+        udpProfile&    prof;
+        bool           active;
+        uint32_t       saved;
+    };
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpProfile ()
+    {
+        for (uint32_t cat = 0; cat < NUM_PROF; cat++)
+        {
+            acc[cat]                   = 0;
+            count[cat]                 = 0;
+        }
+
+        cur                            = PROF_OTHER;
+        owner                          = std::this_thread::get_id();
+        start_clk                      = std::chrono::steady_clock::now();
+        start                          = now();
+        mark                           = start;
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to test whether called on the profile's own thread
+    bool owned (void) {return std::this_thread::get_id() == owner;};
+
+    // Method to switch to a category, returning the previous one
+    uint32_t enter (uint32_t cat)
+    {
+        uint64_t t                     = now();
+        uint32_t prev                  = cur;
+
+        acc[cur]                       += t - mark;
+        mark                           = t;
+        cur                            = cat;
+        count[cat]++;
+
+        return prev;
+    }
+
+    // Method to return to a previous category
+    void leave (uint32_t prev)
+    {
+        uint64_t t                     = now();
+
+        acc[cur]                       += t - mark;
+        mark                           = t;
+        cur                            = prev;
+    }
+
+    // Method to print the time breakdown for a node, given its tick count
+    void print (int node, uint32_t ticks)
+    {
+        static const char* names[NUM_PROF] = {"other C++", "VProc/simulator", "genUdpIpPkt", "processFrame"};
+
+        leave(cur);
+
+        uint64_t total                 = mark - start;
+        double   wall_s                = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_clk).count();
+        double   ns_per_count          = (total && wall_s > 0.0) ? (wall_s * 1e9) / (double)total : 1.0;
+
+        VPrint("Node%d: profile: %.3f s wall, %u ticks, %.0f ticks/s\n", node, wall_s, ticks,
+               wall_s > 0.0 ? (double)ticks / wall_s : 0.0);
+
+        for (uint32_t cat = 0; cat < NUM_PROF; cat++)
+        {
+            VPrint("Node%d:   %-16s %6.2f%%  %10.3f ms", node, names[cat],
+                   total ? (100.0 * (double)acc[cat]) / (double)total : 0.0,
+                   ((double)acc[cat] * ns_per_count) / 1e6);
+
+            if (cat != PROF_OTHER)
+            {
+                VPrint("  %10" PRIu64 " calls  %8.1f ns/call", count[cat],
+                       count[cat] ? ((double)acc[cat] * ns_per_count) / (double)count[cat] : 0.0);
+            }
+
+            VPrint("\n");
+        }
+    }
+
+private:
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    static uint64_t now (void)
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Accumulated time and entry counts per category
+    uint64_t       acc[NUM_PROF];
+    uint64_t       count[NUM_PROF];
+
+    // Current category, and the time it was entered (or last accumulated)
+    uint32_t       cur;
+    uint64_t       mark;
+
+    // Thread updating the profile
+    std::thread::id owner;
+
+    // Start of profiling, in counter and steady_clock time
+    uint64_t       start;
+    std::chrono::steady_clock::time_point start_clk;
+};
+
+// Convenience macro, timing the rest of the enclosing block
+#define UDP_PROF_SCOPE(_prof, _cat) udpProfile::scope _udp_prof_scope(_prof, udpProfile::_cat)
+
+#else
+
+#define UDP_PROF_SCOPE(_prof, _cat)
+
+#endif
+
+#endif
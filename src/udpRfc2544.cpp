@@ -0,0 +1,441 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for RFC 2544 benchmarking of a DUT
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cinttypes>
+
+#include "udpRfc2544.h"
+#include "udpShaper.h"
+
+// --------------------------------------------------
+// Default configuration: all tests, over the RFC 2544
+// Ethernet frame sizes
+// --------------------------------------------------
+
+udpRfc2544::rfcConfig_t udpRfc2544::defaultConfig (void)
+{
+    rfcConfig_t cfg;
+
+    cfg.dst.dst_port                   = 0;
+    cfg.dst.ip_dst_addr                = 0;
+    cfg.dst.mac_dst_addr               = 0;
+    cfg.frame_sizes                    = {64, 128, 256, 512, 1024, 1280, 1518};
+    cfg.tests                          = TEST_ALL;
+    cfg.trial_frames                   = 1000;
+    cfg.settle_ticks                   = 20000;
+    cfg.resolution                     = 1.0;
+    cfg.loss_step                      = 10.0;
+    cfg.b2b_max_frames                 = 1000;
+    cfg.clk_freq                       = CLK1G_FREQ;
+
+    return cfg;
+}
+
+// --------------------------------------------------
+// Run the configured tests
+// --------------------------------------------------
+
+bool udpRfc2544::run (udpIpPg* pUdpIn, const rfcConfig_t &cfgIn)
+{
+    if (pUdpIn == NULL || cfgIn.trial_frames == 0 || cfgIn.b2b_max_frames == 0 || cfgIn.clk_freq == 0 ||
+        cfgIn.resolution <= 0.0 || cfgIn.loss_step <= 0.0)
+    {
+        printf("udpRfc2544::run() : ***ERROR. Invalid configuration\n");
+        return false;
+    }
+
+    for (uint32_t idx = 0; idx < cfgIn.frame_sizes.size(); idx++)
+    {
+        if (cfgIn.frame_sizes[idx] < MIN_FRAME_SIZE || cfgIn.frame_sizes[idx] > MAX_FRAME_SIZE)
+        {
+            printf("udpRfc2544::run() : ***ERROR. Frame size (%d) must be %d to %d bytes\n",
+                   cfgIn.frame_sizes[idx], MIN_FRAME_SIZE, MAX_FRAME_SIZE);
+            return false;
+        }
+    }
+
+    pUdp                               = pUdpIn;
+    cfg                                = cfgIn;
+
+    results.clear();
+
+    for (uint32_t idx = 0; idx < cfg.frame_sizes.size(); idx++)
+    {
+        sizeResult_t res;
+
+        res.frame_size                 = cfg.frame_sizes[idx];
+        res.throughput                 = 0.0;
+        res.lat_frames                 = 0;
+        res.lat_min                    = 0;
+        res.lat_avg                    = 0.0;
+        res.lat_max                    = 0;
+        res.b2b_frames                 = 0;
+
+        // Latency is measured at the throughput rate, so needs the throughput test
+        if (cfg.tests & (TEST_THROUGHPUT | TEST_LATENCY))
+        {
+            res.throughput             = throughputTest(res.frame_size);
+        }
+
+        if (cfg.tests & TEST_LATENCY)
+        {
+            latencyTest(res);
+        }
+
+        if (cfg.tests & TEST_FRAME_LOSS)
+        {
+            frameLossTest(res);
+        }
+
+        if (cfg.tests & TEST_BACK_TO_BACK)
+        {
+            res.b2b_frames             = backToBackTest(res.frame_size);
+        }
+
+        VPrint("RFC2544: %4d byte frames done (throughput %.2f%%)\n", res.frame_size, res.throughput);
+
+        results.push_back(res);
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Send a trial, and count the frames received
+// --------------------------------------------------
+
+udpRfc2544::trialResult_t udpRfc2544::runTrial (uint32_t frame_size, double load, uint32_t num_frames)
+{
+    trialResult_t r                    = {num_frames, 0, NO_TICK, 0, 0};
+
+    // Start a new trial, so that any frames still arriving from the last are ignored
+    {
+        std::lock_guard<std::mutex> guard(lock);
+
+        trial++;
+        trial_len                      = num_frames;
+        rx_count                       = 0;
+        rx_ticks.assign(num_frames, (uint32_t)NO_TICK);
+    }
+
+    tx_ticks.assign(num_frames, 0);
+
+    // Payload header, with the sequence number filled in for each frame, and zero padding
+    uint32_t payload_len               = frame_size - FRAME_OVERHEAD;
+    uint32_t payload[MAX_FRAME_SIZE];
+    uint32_t frame[MAX_FRAME_SIZE + udpVProc::ETH_PREAMBLE + 2];
+
+    for (uint32_t idx = 0; idx < payload_len; idx++)
+    {
+        payload[idx]                   = 0;
+    }
+
+    for (uint32_t idx = 0; idx < 4; idx++)
+    {
+        payload[idx]                   = (HDR_MAGIC >> (24 - 8*idx)) & 0xff;
+        payload[4+idx]                 = (trial     >> (24 - 8*idx)) & 0xff;
+    }
+
+    udpShaper shaper(pUdp);
+    int       flow                     = -1;
+
+    for (uint32_t seq = 0; seq < num_frames; seq++)
+    {
+        for (uint32_t idx = 0; idx < 4; idx++)
+        {
+            payload[8+idx]             = (seq >> (24 - 8*idx)) & 0xff;
+        }
+
+        uint32_t len                   = pUdp->genUdpIpPkt(cfg.dst, frame, payload, payload_len);
+
+        // Pace at the offered load, with a bucket of one frame, so there are no bursts
+        if (flow < 0)
+        {
+            flow                       = shaper.addFlow(udpShaper::lineRate(load), len + udpShaper::IFG_TICKS);
+        }
+
+        tx_ticks[seq]                  = shaper.sendFrame(flow, frame, len);
+    }
+
+    // Let the DUT drain, then collect the frames received
+    pUdp->UdpVpSendIdle(cfg.settle_ticks);
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    uint32_t wire_ticks                = frame_size + udpVProc::ETH_PREAMBLE;
+
+    for (uint32_t seq = 0; seq < num_frames; seq++)
+    {
+        if (rx_ticks[seq] != NO_TICK)
+        {
+            uint32_t lat               = rx_ticks[seq] - tx_ticks[seq] - wire_ticks;
+
+            r.lat_min                  = (lat < r.lat_min) ? lat : r.lat_min;
+            r.lat_max                  = (lat > r.lat_max) ? lat : r.lat_max;
+            r.lat_sum                  += lat;
+        }
+    }
+
+    r.received                         = rx_count;
+
+    return r;
+}
+
+// --------------------------------------------------
+// Throughput: binary search for the highest load
+// with no loss, starting at line rate
+// --------------------------------------------------
+
+double udpRfc2544::throughputTest (uint32_t frame_size)
+{
+    double lo                          = 0.0;
+    double hi                          = 100.0;
+    double load                        = 100.0;
+
+    while (true)
+    {
+        trialResult_t r                = runTrial(frame_size, load, cfg.trial_frames);
+
+        if (r.received == r.sent)
+        {
+            lo                         = load;
+        }
+        else
+        {
+            hi                         = load;
+        }
+
+        if (lo == 100.0 || (hi - lo) <= cfg.resolution)
+        {
+            break;
+        }
+
+        load                           = (lo + hi) / 2.0;
+    }
+
+    return lo;
+}
+
+// --------------------------------------------------
+// Latency, at the throughput rate
+// --------------------------------------------------
+
+void udpRfc2544::latencyTest (sizeResult_t &res)
+{
+    if (res.throughput == 0.0)
+    {
+        return;
+    }
+
+    trialResult_t r                    = runTrial(res.frame_size, res.throughput, cfg.trial_frames);
+
+    res.lat_frames                     = r.received;
+
+    if (r.received)
+    {
+        res.lat_min                    = r.lat_min;
+        res.lat_avg                    = (double)r.lat_sum / (double)r.received;
+        res.lat_max                    = r.lat_max;
+    }
+}
+
+// --------------------------------------------------
+// Frame loss rate, stepping down from line rate
+// until two successive trials have no loss
+// --------------------------------------------------
+
+void udpRfc2544::frameLossTest (sizeResult_t &res)
+{
+    uint32_t no_loss                   = 0;
+
+    for (double load = 100.0; load > 0.0 && no_loss < 2; load -= cfg.loss_step)
+    {
+        trialResult_t r                = runTrial(res.frame_size, load, cfg.trial_frames);
+        lossPoint_t   p;
+
+        p.load                         = load;
+        p.loss                         = 100.0 * (double)(r.sent - r.received) / (double)r.sent;
+
+        res.loss.push_back(p);
+
+        no_loss                        = (r.received == r.sent) ? no_loss + 1 : 0;
+    }
+}
+
+// --------------------------------------------------
+// Back-to-back: binary search for the longest burst
+// at line rate with no loss
+// --------------------------------------------------
+
+uint32_t udpRfc2544::backToBackTest (uint32_t frame_size)
+{
+    // lo is a burst length known to pass, and hi one known to fail
+    uint32_t lo                        = 0;
+    uint32_t hi                        = cfg.b2b_max_frames + 1;
+    uint32_t len                       = cfg.b2b_max_frames;
+
+    while (hi - lo > 1)
+    {
+        trialResult_t r                = runTrial(frame_size, 100.0, len);
+
+        if (r.received == r.sent)
+        {
+            lo                         = len;
+        }
+        else
+        {
+            hi                         = len;
+        }
+
+        len                            = (lo + hi) / 2;
+    }
+
+    return lo;
+}
+
+// --------------------------------------------------
+// Count a received test frame
+// --------------------------------------------------
+
+bool udpRfc2544::received (const uint8_t* payload, uint32_t len, uint32_t tick)
+{
+    if (!isTestPayload(payload, len))
+    {
+        return false;
+    }
+
+    uint32_t frame_trial               = getWord(payload, 4);
+    uint32_t seq                       = getWord(payload, 8);
+
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (frame_trial != trial || seq >= trial_len || rx_ticks[seq] != NO_TICK)
+    {
+        rx_stale++;
+    }
+    else
+    {
+        rx_ticks[seq]                  = tick;
+        rx_count++;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Print a summary of the results
+// --------------------------------------------------
+
+void udpRfc2544::printReport (int node)
+{
+    VPrint("Node%d: RFC2544 results (%d frame trials)\n", node, cfg.trial_frames);
+    VPrint("Node%d:   size  throughput         frames/s   latency min/avg/max (ns)   back-to-back\n", node);
+
+    for (uint32_t idx = 0; idx < results.size(); idx++)
+    {
+        sizeResult_t &r                = results[idx];
+
+        VPrint("Node%d:   %4d  %9.2f%%  %15.0f   %7.0f/%7.0f/%7.0f   %12d\n",
+               node, r.frame_size, r.throughput, framesPerSec(r.frame_size, r.throughput),
+               ticksToNs(r.lat_min), ticksToNs(r.lat_avg), ticksToNs(r.lat_max), r.b2b_frames);
+    }
+
+    if (rx_stale)
+    {
+        VPrint("Node%d:   %" PRIu64 " frames received from earlier trials, or duplicated\n", node, rx_stale);
+    }
+}
+
+// --------------------------------------------------
+// Write the results as a JSON report
+// --------------------------------------------------
+
+bool udpRfc2544::writeReport (const char* fname)
+{
+    FILE* fp                           = fopen(fname, "w");
+
+    if (fp == NULL)
+    {
+        printf("udpRfc2544::writeReport() : ***ERROR. Unable to open %s for writing\n", fname);
+        return false;
+    }
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"clk_freq\": %u,\n",       cfg.clk_freq);
+    fprintf(fp, "  \"trial_frames\": %u,\n",   cfg.trial_frames);
+    fprintf(fp, "  \"settle_ticks\": %u,\n",   cfg.settle_ticks);
+    fprintf(fp, "  \"resolution\": %g,\n",     cfg.resolution);
+    fprintf(fp, "  \"stale_frames\": %" PRIu64 ",\n", rx_stale);
+    fprintf(fp, "  \"results\": [\n");
+
+    for (uint32_t idx = 0; idx < results.size(); idx++)
+    {
+        sizeResult_t &r                = results[idx];
+        double        fps              = framesPerSec(r.frame_size, r.throughput);
+        double        frame_ns         = ticksToNs(r.frame_size);
+
+        fprintf(fp, "    {\n");
+        fprintf(fp, "      \"frame_size\": %u,\n", r.frame_size);
+
+        if (cfg.tests & (TEST_THROUGHPUT | TEST_LATENCY))
+        {
+            fprintf(fp, "      \"throughput\": {\"load_pct\": %.3f, \"frames_per_sec\": %.1f, \"mbps\": %.3f},\n",
+                    r.throughput, fps, fps * r.frame_size * 8.0 / 1e6);
+        }
+
+        if (cfg.tests & TEST_LATENCY)
+        {
+            fprintf(fp, "      \"latency\": {\"frames\": %u, \"lilo_ns\": {\"min\": %.1f, \"avg\": %.1f, \"max\": %.1f}, "
+                        "\"store_forward_ns\": {\"min\": %.1f, \"avg\": %.1f, \"max\": %.1f}},\n",
+                    r.lat_frames,
+                    ticksToNs(r.lat_min), ticksToNs(r.lat_avg), ticksToNs(r.lat_max),
+                    ticksToNs(r.lat_min) - frame_ns, ticksToNs(r.lat_avg) - frame_ns, ticksToNs(r.lat_max) - frame_ns);
+        }
+
+        if (cfg.tests & TEST_FRAME_LOSS)
+        {
+            fprintf(fp, "      \"frame_loss\": [");
+
+            for (uint32_t pidx = 0; pidx < r.loss.size(); pidx++)
+            {
+                fprintf(fp, "%s{\"load_pct\": %.3f, \"loss_pct\": %.3f}", pidx ? ", " : "", r.loss[pidx].load, r.loss[pidx].loss);
+            }
+
+            fprintf(fp, "],\n");
+        }
+
+        if (cfg.tests & TEST_BACK_TO_BACK)
+        {
+            fprintf(fp, "      \"back_to_back\": {\"frames\": %u, \"max_frames\": %u},\n", r.b2b_frames, cfg.b2b_max_frames);
+        }
+
+        fprintf(fp, "      \"wire_ticks\": %u\n", r.frame_size + WIRE_OVERHEAD);
+        fprintf(fp, "    }%s\n", (idx + 1 < results.size()) ? "," : "");
+    }
+
+    fprintf(fp, "  ]\n");
+    fprintf(fp, "}\n");
+
+    fclose(fp);
+
+    return true;
+}
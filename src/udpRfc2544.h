@@ -0,0 +1,231 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for RFC 2544 benchmarking of a DUT
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_RFC2544_H_
+#define _UDP_RFC2544_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+#include "udpIpPg.h"
+
+// -------------------------------------------------------------
+// RFC 2544 benchmark driver. run() is called on the node
+// sending into the DUT, and received() from the receive
+// callback of the node the DUT forwards to, which may be on
+// another thread. For each frame size (64 to 1518 bytes,
+// including FCS, by default) it measures:
+//
+//   Throughput (26.1): the highest offered load, as a
+//     percentage of line rate, with no frames lost, found by a
+//     binary search to within a set resolution.
+//   Latency (26.2): minimum, average and maximum, over all the
+//     frames of a trial at the throughput rate.
+//   Frame loss rate (26.3): loss at offered loads from 100% in
+//     set steps, until two successive trials lose no frames.
+//   Back-to-back (26.4): the longest burst at line rate with no
+//     frames lost, found by a binary search.
+//
+// Trials are a number of frames, rather than a duration, paced
+// with a udpShaper. After each trial, the sender idles for a
+// settling time before the frames received are counted. Each
+// test frame's UDP payload starts with a header of a magic
+// number, trial number and sequence number, so frames from
+// earlier trials, or duplicates, are not counted.
+//
+// Latency is measured from the first byte of a frame sent to
+// the end of the frame received, less the frame's time on the
+// wire, which gives last-in last-out latency. For a store and
+// forward DUT, the RFC 1242 latency (last bit in to first bit
+// out) is this less the frame's length, which is also reported
+// (and is negative for a cut-through DUT).
+// -------------------------------------------------------------
+
+class udpRfc2544
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Tests to run
+    static const uint32_t TEST_THROUGHPUT      = 0x1;
+    static const uint32_t TEST_LATENCY         = 0x2;
+    static const uint32_t TEST_FRAME_LOSS      = 0x4;
+    static const uint32_t TEST_BACK_TO_BACK    = 0x8;
+    static const uint32_t TEST_ALL             = 0xf;
+
+    // Test frame payload header
+    static const uint32_t HDR_MAGIC            = 0x52464332; // "RFC2"
+    static const uint32_t HDR_LEN              = 12;         // BYTES
+
+    // Frame dimensions: bytes added by the UDP, IPv4 and Ethernet layers to a payload,
+    // and bytes on the wire per frame in addition to its length (preamble, SFD and IFG)
+    static const uint32_t FRAME_OVERHEAD       = 8 + 20 + udpVProc::ETH_HDR_LEN + udpVProc::ETH_CRC_LEN; // BYTES
+    static const uint32_t WIRE_OVERHEAD        = udpVProc::ETH_PREAMBLE + 12; // BYTES
+
+    // Frame size limits
+    static const uint32_t MIN_FRAME_SIZE       = 64;   // BYTES
+    static const uint32_t MAX_FRAME_SIZE       = 1518; // BYTES
+
+    // Nominal 1G clock frequency (Hz), with one byte per tick
+    static const uint32_t CLK1G_FREQ           = 125000000;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        udpIpPg::udpConfig_t  dst;             // Destination, as seen by the DUT
+        std::vector<uint32_t> frame_sizes;     // Bytes, including FCS
+        uint32_t              tests;           // TEST_xxx
+        uint32_t              trial_frames;    // Frames per trial
+        uint32_t              settle_ticks;    // Idle after a trial, before counting
+        double                resolution;      // Throughput search resolution (% of line rate)
+        double                loss_step;       // Frame loss sweep load step (% of line rate)
+        uint32_t              b2b_max_frames;  // Longest back-to-back burst tried
+        uint32_t              clk_freq;        // Clock frequency (Hz), for rates and times
+    } rfcConfig_t;
+
+    // Frame loss at an offered load
+    typedef struct {
+        double                load;            // % of line rate
+        double                loss;            // % of frames sent
+    } lossPoint_t;
+
+    // Results for a frame size
+    typedef struct {
+        uint32_t              frame_size;
+        double                throughput;      // % of line rate
+        uint32_t              lat_frames;      // Frames in the latency measurement
+        uint32_t              lat_min;         // LILO latency (ticks)
+        double                lat_avg;
+        uint32_t              lat_max;
+        std::vector<lossPoint_t> loss;
+        uint32_t              b2b_frames;
+    } sizeResult_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpRfc2544 ()
+    {
+        pUdp                           = NULL;
+        cfg                            = defaultConfig();
+        trial                          = 0;
+        trial_len                      = 0;
+        rx_count                       = 0;
+        rx_stale                       = 0;
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to return a configuration for all tests over the standard frame sizes
+    static rfcConfig_t defaultConfig   (void);
+
+    // Method to run the configured tests, sending on the given node. Returns false on error.
+    bool           run                 (udpIpPg* pUdp, const rfcConfig_t &cfg);
+
+    // Method, called by the receiving node, to count a received UDP payload. Returns
+    // true if it was a test frame. May be called from another node's thread.
+    bool           received            (const uint8_t* payload, uint32_t len, uint32_t tick);
+
+    // Method to test for a test frame payload
+    static bool    isTestPayload       (const uint8_t* payload, uint32_t len) {return len >= HDR_LEN && getWord(payload, 0) == HDR_MAGIC;};
+
+    // Results output: a summary to the console, and a JSON report to a file. writeReport()
+    // returns false on error.
+    void           printReport         (int node);
+    bool           writeReport         (const char* fname);
+
+    // Results access
+    std::vector<sizeResult_t>& getResults (void) {return results;};
+
+private:
+
+    // --------------------------------------------
+    // Private types
+    // --------------------------------------------
+
+    // Outcome of a trial
+    typedef struct {
+        uint32_t       sent;
+        uint32_t       received;
+        uint32_t       lat_min;
+        uint32_t       lat_max;
+        uint64_t       lat_sum;
+    } trialResult_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to send a trial of num_frames frames of a size, at an offered load
+    trialResult_t  runTrial            (uint32_t frame_size, double load, uint32_t num_frames);
+
+    // Methods for each test, for a frame size
+    double         throughputTest      (uint32_t frame_size);
+    void           latencyTest         (sizeResult_t &res);
+    void           frameLossTest       (sizeResult_t &res);
+    uint32_t       backToBackTest      (uint32_t frame_size);
+
+    // Rate conversions, for a frame size and load
+    double         framesPerSec        (uint32_t frame_size, double load) {return (load / 100.0) * (double)cfg.clk_freq / (double)(frame_size + WIRE_OVERHEAD);};
+    double         ticksToNs           (double ticks)                     {return ticks * 1e9 / (double)cfg.clk_freq;};
+
+    static uint32_t getWord            (const uint8_t* buf, uint32_t idx) {return ((uint32_t)buf[idx] << 24) | (buf[idx+1] << 16) | (buf[idx+2] << 8) | buf[idx+3];};
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Sending node, and the configuration being run
+    udpIpPg*       pUdp;
+    rfcConfig_t    cfg;
+
+    // Results, per frame size
+    std::vector<sizeResult_t> results;
+
+    // TX start tick of each frame of the current trial (sending node only)
+    std::vector<uint32_t>     tx_ticks;
+
+    // Receive state, shared with the receiving node: current trial and its length,
+    // RX tick of each frame (or NO_TICK), and counts of frames received, and of frames
+    // from earlier trials or duplicated
+    static const uint32_t     NO_TICK         = 0xffffffff;
+
+    std::mutex                lock;
+    uint32_t                  trial;
+    uint32_t                  trial_len;
+    std::vector<uint32_t>     rx_ticks;
+    uint32_t                  rx_count;
+    uint64_t                  rx_stale;
+};
+
+#endif
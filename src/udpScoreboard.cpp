@@ -0,0 +1,268 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for a TX to RX datagram scoreboard
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cstring>
+#include <cinttypes>
+
+extern "C" {
+#include "VUser.h"
+}
+
+#include "udpScoreboard.h"
+#include "udpPayload.h"
+
+// --------------------------------------------------
+// Record a transmitted datagram
+// --------------------------------------------------
+
+void udpScoreboard::sent (uint32_t flow, uint32_t seq, uint64_t digest, uint32_t tick)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    expire(tick);
+
+    uint64_t k                         = key(flow, seq);
+    txEntry_t entry                    = {digest, tick};
+
+    outstanding[k]                     = entry;
+    tx_order.push_back({k, tick});
+
+    stats.sent++;
+}
+
+// --------------------------------------------------
+// Match a received datagram
+// --------------------------------------------------
+
+uint32_t udpScoreboard::received (uint32_t flow, uint32_t seq, uint64_t digest, uint32_t tick)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    expire(tick);
+
+    uint64_t     k                     = key(flow, seq);
+    flowState_t &f                     = flows[flow];
+    auto         it                    = outstanding.find(k);
+    uint32_t     result;
+
+    if (it != outstanding.end())
+    {
+        if (it->second.digest == digest)
+        {
+            result                     = SB_MATCH;
+            stats.matched++;
+        }
+        else
+        {
+            result                     = SB_CORRUPT;
+            stats.corrupted++;
+        }
+
+        // Arriving behind a later sequence number is a reorder
+        if (f.any_rx && (int32_t)(seq - f.max_seq) < 0)
+        {
+            stats.reordered++;
+        }
+
+        outstanding.erase(it);
+    }
+    else if (inWindow(f, seq) && testBit(f.rx_bits, seq))
+    {
+        result                         = SB_DUPLICATE;
+        stats.duplicated++;
+    }
+    else if (expired.erase(k))
+    {
+        // Counted as lost when it expired, so now count as late instead
+        result                         = SB_LATE;
+        stats.lost--;
+        stats.late++;
+    }
+    else
+    {
+        result                         = SB_UNEXPECTED;
+        stats.unexpected++;
+    }
+
+    advanceWindow(f, seq);
+
+    return result;
+}
+
+// --------------------------------------------------
+// Record/match udpPayload pattern payloads
+// --------------------------------------------------
+
+void udpScoreboard::sentPayload (const uint32_t* payload, uint32_t len, uint32_t tick)
+{
+    if (len >= udpPayload::HDR_LEN)
+    {
+        sent(udpPayload::getFlow(payload), udpPayload::getSeq(payload), digest(payload, len), tick);
+    }
+}
+
+uint32_t udpScoreboard::receivedPayload (const uint8_t* payload, uint32_t len, uint32_t tick)
+{
+    if (!udpPayload::isPatternPayload(payload, len))
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stats.unexpected++;
+        return SB_UNEXPECTED;
+    }
+
+    return received(udpPayload::getFlow(payload), udpPayload::getSeq(payload), digest(payload, len), tick);
+}
+
+// --------------------------------------------------
+// Move a flow's received sequence number window
+// forward to include seq, and mark it as received
+// --------------------------------------------------
+
+void udpScoreboard::advanceWindow (flowState_t &f, uint32_t seq)
+{
+    if (!f.any_rx)
+    {
+        memset(f.rx_bits, 0, sizeof(f.rx_bits));
+        f.any_rx                       = true;
+        f.max_seq                      = seq;
+    }
+    else if ((int32_t)(seq - f.max_seq) > 0)
+    {
+        uint32_t advance               = seq - f.max_seq;
+
+        if (advance >= SEQ_WINDOW)
+        {
+            memset(f.rx_bits, 0, sizeof(f.rx_bits));
+        }
+        else
+        {
+            // Clear the flags for the sequence numbers entering the window
+            for (uint32_t s = f.max_seq + 1; s != seq + 1; s++)
+            {
+                f.rx_bits[(s / 64) % (SEQ_WINDOW/64)] &= ~(1ULL << (s % 64));
+            }
+        }
+
+        f.max_seq                      = seq;
+    }
+
+    if (inWindow(f, seq))
+    {
+        setBit(f.rx_bits, seq);
+    }
+}
+
+// --------------------------------------------------
+// Expire outstanding datagrams older than the expiry
+// window, or the oldest if there are too many, as
+// lost. Already matched datagrams are dropped from
+// the send order as they reach its head.
+// --------------------------------------------------
+
+void udpScoreboard::expire (uint32_t tick)
+{
+    while (!tx_order.empty())
+    {
+        txOrder_t &oldest              = tx_order.front();
+        auto       it                  = outstanding.find(oldest.key);
+
+        if (it != outstanding.end())
+        {
+            if ((tick - oldest.tick) <= expiry_ticks && outstanding.size() <= max_entries)
+            {
+                break;
+            }
+
+            outstanding.erase(it);
+            stats.lost++;
+
+            // Remember it, for a bounded time, in case it arrives late
+            expired.insert(oldest.key);
+            expired_order.push_back(oldest.key);
+
+            if (expired_order.size() > max_entries)
+            {
+                expired.erase(expired_order.front());
+                expired_order.pop_front();
+            }
+        }
+
+        tx_order.pop_front();
+    }
+}
+
+// --------------------------------------------------
+// Count everything outstanding as lost
+// --------------------------------------------------
+
+void udpScoreboard::finalise (void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    stats.lost                         += outstanding.size();
+
+    outstanding.clear();
+    tx_order.clear();
+}
+
+// --------------------------------------------------
+// Test status and statistics
+// --------------------------------------------------
+
+bool udpScoreboard::passed (void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return stats.lost == expected_lost && stats.corrupted == 0 && stats.duplicated == 0 && stats.late == 0 &&
+           stats.unexpected == 0 && (allow_reorder || stats.reordered == 0);
+}
+
+udpScoreboard::sbStats_t udpScoreboard::getStats (void)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    return stats;
+}
+
+void udpScoreboard::clearStats (void)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+void udpScoreboard::printReport (void)
+{
+    sbStats_t s                        = getStats();
+    bool      pass                     = passed();
+
+    VPrint("Scoreboard: sent %" PRIu64 ", matched %" PRIu64 ", lost %" PRIu64 ", reordered %" PRIu64 "\n",
+           s.sent, s.matched, s.lost, s.reordered);
+    VPrint("Scoreboard: duplicated %" PRIu64 ", corrupted %" PRIu64 ", late %" PRIu64 ", unexpected %" PRIu64 "\n",
+           s.duplicated, s.corrupted, s.late, s.unexpected);
+
+    if (expected_lost)
+    {
+        VPrint("Scoreboard: expected lost %" PRIu64 "\n", expected_lost);
+    }
+
+    VPrint("Scoreboard: %s\n", pass ? "PASS" : "***ERROR. FAIL");
+}
@@ -0,0 +1,212 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for a TX to RX datagram scoreboard
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_SCOREBOARD_H_
+#define _UDP_SCOREBOARD_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+// -------------------------------------------------------------
+// Scoreboard, shared between nodes, matching received datagrams
+// against those transmitted. Each datagram is identified by a
+// flow ID and sequence number, and its payload is summarised by
+// a 64 bit digest. Transmitted datagrams are held in a hash map
+// until received, or until they are older than the expiry
+// window (or the map is full), when they are counted as lost.
+//
+// Per flow, a sliding window of received sequence numbers is
+// kept to detect duplicates, and a bounded set of recently
+// expired datagrams to detect late arrivals, so that memory use
+// is constant.
+//
+// The sentPayload()/receivedPayload() methods take the flow and
+// sequence number from a udpPayload pattern header.
+// -------------------------------------------------------------
+
+class udpScoreboard
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Receive match results
+    static const uint32_t SB_MATCH             = 0;
+    static const uint32_t SB_CORRUPT           = 1;
+    static const uint32_t SB_DUPLICATE         = 2;
+    static const uint32_t SB_LATE              = 3;  // Arrived after expiry
+    static const uint32_t SB_UNEXPECTED        = 4;
+
+    // Defaults for the expiry window and maximum outstanding datagrams
+    static const uint32_t DEFAULT_EXPIRY_TICKS = 1000000;
+    static const uint32_t DEFAULT_MAX_ENTRIES  = 65536;
+
+    // Size of each flow's received sequence number window
+    static const uint32_t SEQ_WINDOW           = 1024;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        uint64_t sent;
+        uint64_t matched;
+        uint64_t lost;
+        uint64_t reordered;
+        uint64_t duplicated;
+        uint64_t corrupted;
+        uint64_t late;
+        uint64_t unexpected;
+    } sbStats_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpScoreboard (uint32_t expiryTicksIn = DEFAULT_EXPIRY_TICKS, uint32_t maxEntriesIn = DEFAULT_MAX_ENTRIES)
+    {
+        expiry_ticks                   = expiryTicksIn;
+        max_entries                    = maxEntriesIn;
+        allow_reorder                  = true;
+        expected_lost                  = 0;
+
+        outstanding.reserve(max_entries);
+        clearStats();
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to record a transmitted datagram
+    void           sent                (uint32_t flow, uint32_t seq, uint64_t digest, uint32_t tick);
+
+    // Method to match a received datagram, returning an SB_xxx result
+    uint32_t       received            (uint32_t flow, uint32_t seq, uint64_t digest, uint32_t tick);
+
+    // Methods to record/match a udpPayload pattern payload (one byte per word on TX)
+    void           sentPayload         (const uint32_t* payload, uint32_t len, uint32_t tick);
+    uint32_t       receivedPayload     (const uint8_t* payload, uint32_t len, uint32_t tick);
+
+    // Method to count all datagrams still outstanding as lost, at the end of a test
+    void           finalise            (void);
+
+    // Method to select whether reordering fails a test (allowed by default)
+    void           setAllowReorder     (bool allow) {allow_reorder = allow;};
+
+    // Method to set the number of datagrams expected to be lost (e.g. to injected faults)
+    void           setExpectedLost     (uint64_t lost) {expected_lost = lost;};
+
+    // Test status and statistics
+    bool           passed              (void);
+    sbStats_t      getStats            (void);
+    void           clearStats          (void);
+    void           printReport         (void);
+
+    // Payload digest (64 bit FNV-1a), for bytes or one byte per word
+    template<typename T>
+    static uint64_t digest             (const T* buf, uint32_t len)
+    {
+        uint64_t h                     = 0xcbf29ce484222325ULL;
+        for (uint32_t idx = 0; idx < len; idx++)
+        {
+            h                          = (h ^ (buf[idx] & 0xff)) * 0x100000001b3ULL;
+        }
+        return h;
+    };
+
+private:
+
+    // --------------------------------------------
+    // Private type definitions
+    // --------------------------------------------
+
+    // An outstanding transmitted datagram
+    typedef struct {
+        uint64_t digest;
+        uint32_t tick;
+    } txEntry_t;
+
+    // A transmitted datagram in send order, for expiry
+    typedef struct {
+        uint64_t key;
+        uint32_t tick;
+    } txOrder_t;
+
+    // Per flow receive state
+    typedef struct {
+        bool     any_rx;
+        uint32_t max_seq;                     // Highest sequence number received
+        uint64_t rx_bits[SEQ_WINDOW/64];      // Received flags, for max_seq and below
+    } flowState_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    static uint64_t key                (uint32_t flow, uint32_t seq) {return ((uint64_t)flow << 32) | seq;};
+
+    // Method to expire outstanding datagrams older than the window, or when full
+    void           expire              (uint32_t tick);
+
+    // Methods to access a flow's sequence number window
+    static bool    inWindow            (flowState_t &f, uint32_t seq) {return f.any_rx && (f.max_seq - seq) < SEQ_WINDOW;};
+    static bool    testBit             (uint64_t* bits, uint32_t seq) {return (bits[(seq / 64) % (SEQ_WINDOW/64)] >> (seq % 64)) & 1;};
+    static void    setBit              (uint64_t* bits, uint32_t seq) {bits[(seq / 64) % (SEQ_WINDOW/64)] |= 1ULL << (seq % 64);};
+    void           advanceWindow       (flowState_t &f, uint32_t seq);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Configuration
+    uint32_t                                  expiry_ticks;
+    uint32_t                                  max_entries;
+    bool                                      allow_reorder;
+    uint64_t                                  expected_lost;
+
+    // Outstanding transmitted datagrams, and their send order
+    std::unordered_map<uint64_t, txEntry_t>   outstanding;
+    std::deque<txOrder_t>                     tx_order;
+
+    // Recently expired datagrams, and their expiry order
+    std::unordered_set<uint64_t>              expired;
+    std::deque<uint64_t>                      expired_order;
+
+    // Per flow receive state
+    std::unordered_map<uint32_t, flowState_t> flows;
+
+    // Statistics
+    sbStats_t                                 stats;
+
+    // Nodes may be on separate threads
+    std::mutex                                lock;
+};
+
+#endif
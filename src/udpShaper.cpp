@@ -0,0 +1,241 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for per-flow token bucket transmit
+// shaping
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <cinttypes>
+
+#include "udpShaper.h"
+
+// --------------------------------------------------
+// Add a flow
+// --------------------------------------------------
+
+int udpShaper::addFlow (uint64_t rate_bps, uint32_t burst_bytes)
+{
+    if (rate_bps == 0 || rate_bps > LINE_RATE_BPS)
+    {
+        printf("udpShaper::addFlow() : ***ERROR. Rate (%" PRIu64 " bits/s) must be non-zero and <= %" PRIu64 "\n",
+               rate_bps, LINE_RATE_BPS);
+        return -1;
+    }
+
+    if (burst_bytes == 0)
+    {
+        printf("udpShaper::addFlow() : ***ERROR. Burst size must be non-zero\n");
+        return -1;
+    }
+
+    flow_t f;
+
+    f.rate                             = rate_bps;
+    f.cap                              = (int64_t)burst_bytes * (int64_t)LINE_RATE_BPS;
+    f.tokens                           = f.cap;
+    f.last_tick                        = pVp->UdpVpGetTicks();
+    f.stats.frames                     = 0;
+    f.stats.wire_bytes                 = 0;
+    f.stats.first_tick                 = 0;
+    f.stats.last_tick                  = 0;
+
+    flows.push_back(f);
+
+    return flows.size() - 1;
+}
+
+// --------------------------------------------------
+// Queue a frame on a flow
+// --------------------------------------------------
+
+bool udpShaper::queueFrame (uint32_t flow, const uint32_t* frame, uint32_t len)
+{
+    if (flow >= flows.size())
+    {
+        printf("udpShaper::queueFrame() : ***ERROR. Invalid flow (%d)\n", flow);
+        return false;
+    }
+
+    if (len == 0)
+    {
+        printf("udpShaper::queueFrame() : ***ERROR. Zero length frame\n");
+        return false;
+    }
+
+    flows[flow].queue.emplace_back(frame, frame + len);
+
+    return true;
+}
+
+// --------------------------------------------------
+// Add the tokens accrued by a flow since it was last
+// updated, saturating at the bucket size
+// --------------------------------------------------
+
+void udpShaper::refill (flow_t &f, uint32_t tick)
+{
+    uint64_t elapsed                   = tick - f.last_tick;
+    uint64_t room                      = f.cap - f.tokens;
+
+    f.tokens                           = (elapsed >= room / f.rate + 1) ? f.cap : f.tokens + (int64_t)(elapsed * f.rate);
+    f.last_tick                        = tick;
+}
+
+// --------------------------------------------------
+// Return the ticks until a flow can afford its next
+// frame. If the burst size is smaller than the frame,
+// a full bucket is sufficient (with the bucket going
+// negative), so that the long term rate is kept.
+// --------------------------------------------------
+
+uint64_t udpShaper::ticksToEligible (const flow_t &f)
+{
+    int64_t need                       = cost(f.queue.front().size());
+
+    need                               = (need > f.cap) ? f.cap : need;
+
+    if (f.tokens >= need)
+    {
+        return 0;
+    }
+
+    return ((uint64_t)(need - f.tokens) + f.rate - 1) / f.rate;
+}
+
+// --------------------------------------------------
+// Send all queued frames, each starting on the first
+// tick that both its flow can afford it and the
+// minimum IFG since the previous frame has passed.
+// --------------------------------------------------
+
+uint32_t udpShaper::run (void)
+{
+    uint32_t sent                      = 0;
+
+    while (true)
+    {
+        uint32_t now                   = pVp->UdpVpGetTicks();
+
+        if (!started)
+        {
+            next_tx_tick               = now;
+            started                    = true;
+        }
+
+        // Find the flow eligible soonest, round robin from the last served for ties
+        int      best                  = -1;
+        uint64_t best_wait             = 0;
+
+        for (uint32_t idx = 0; idx < flows.size(); idx++)
+        {
+            uint32_t fidx              = (last_flow + 1 + idx) % flows.size();
+            flow_t  &f                 = flows[fidx];
+
+            if (!f.queue.empty())
+            {
+                refill(f, now);
+
+                uint64_t wait          = ticksToEligible(f);
+
+                if (best < 0 || wait < best_wait)
+                {
+                    best               = fidx;
+                    best_wait          = wait;
+                }
+            }
+        }
+
+        if (best < 0)
+        {
+            break;
+        }
+
+        // Start on the later of the flow's eligibility and the end of the minimum IFG
+        uint32_t start                 = now + best_wait;
+
+        if ((int32_t)(next_tx_tick - start) > 0)
+        {
+            start                      = next_tx_tick;
+        }
+
+        if (start != now)
+        {
+            pVp->UdpVpSendIdle(start - now);
+        }
+
+        flow_t                &f       = flows[best];
+        std::vector<uint32_t> &frame   = f.queue.front();
+        uint32_t               len     = frame.size();
+
+        last_start_tick                = pVp->UdpVpGetTicks();
+
+        refill(f, last_start_tick);
+        f.tokens                       -= cost(len);
+
+        pVp->UdpVpSendRawEthFrame(frame.data(), len);
+
+        next_tx_tick                   = pVp->UdpVpGetTicks() + IFG_TICKS - TX_GAP_TICKS;
+
+        if (f.stats.frames == 0)
+        {
+            f.stats.first_tick         = last_start_tick;
+        }
+        f.stats.frames++;
+        f.stats.wire_bytes             += len + IFG_TICKS;
+        f.stats.last_tick              = next_tx_tick;
+
+        f.queue.pop_front();
+        last_flow                      = best;
+        sent++;
+    }
+
+    return sent;
+}
+
+// --------------------------------------------------
+// Send a single frame on a flow
+// --------------------------------------------------
+
+uint32_t udpShaper::sendFrame (uint32_t flow, const uint32_t* frame, uint32_t len)
+{
+    if (queueFrame(flow, frame, len))
+    {
+        run();
+    }
+
+    return last_start_tick;
+}
+
+// --------------------------------------------------
+// Print the achieved rate of each flow
+// --------------------------------------------------
+
+void udpShaper::printStats (int node)
+{
+    for (uint32_t idx = 0; idx < flows.size(); idx++)
+    {
+        flowStats_t &s                 = flows[idx].stats;
+        uint32_t     ticks             = s.last_tick - s.first_tick;
+        double       pct               = ticks ? 100.0 * (double)s.wire_bytes / (double)ticks : 0.0;
+
+        VPrint("Node%d: Shaper flow %d: %" PRIu64 " frames, %" PRIu64 " wire bytes in %u ticks (%.3f%% of line rate, configured %.3f%%)\n",
+               node, idx, s.frames, s.wire_bytes, ticks, pct, 100.0 * (double)flows[idx].rate / (double)LINE_RATE_BPS);
+    }
+}
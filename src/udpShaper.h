@@ -0,0 +1,167 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for per-flow token bucket transmit shaping
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_SHAPER_H_
+#define _UDP_SHAPER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <deque>
+
+#include "udpVProc.h"
+
+// -------------------------------------------------------------
+// Token bucket shaper layered over udpVProc's send path. Each
+// flow has a rate, in bits/s, and a burst size, in bytes.
+// Queued frames are sent in order within a flow, with the flow
+// whose bucket can first afford its next frame going next, and
+// the idle time between frames is calculated so that each frame
+// starts on the exact tick it becomes eligible.
+//
+// Rates are measured on the wire, with each frame costing its
+// length (including preamble and SFD) plus the minimum 96 bit
+// IFG, so that 100% (LINE_RATE_BPS) is back to back frames.
+// Bucket state is held as an integer in units of 1/LINE_RATE_BPS
+// of a byte, so the long term rate is exact. The minimum IFG is
+// always enforced between frames, whatever the flows' state.
+//
+// The shaper assumes it is the only sender on the node.
+// -------------------------------------------------------------
+
+class udpShaper
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Line rate, with one byte sent per tick
+    static const uint64_t LINE_RATE_BPS        = 1000000000ULL;
+
+    // Minimum inter-frame gap (96 bits)
+    static const uint32_t IFG_TICKS            = 12;
+
+    // Idle ticks already added after a frame by UdpVpSendRawEthFrame()
+    static const uint32_t TX_GAP_TICKS         = 1;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Per-flow statistics
+    typedef struct {
+        uint64_t          frames;
+        uint64_t          wire_bytes;   // Including IFG
+        uint32_t          first_tick;
+        uint32_t          last_tick;    // Tick after last frame's minimum IFG
+    } flowStats_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpShaper (udpVProc* pVpIn) : pVp(pVpIn)
+    {
+        next_tx_tick                   = 0;
+        last_flow                      = 0;
+        last_start_tick                = 0;
+        started                        = false;
+    };
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to convert a percentage of line rate to bits/s
+    static uint64_t lineRate           (double percent) {return (uint64_t)(percent * (double)LINE_RATE_BPS / 100.0 + 0.5);};
+
+    // Method to add a flow with a rate (bits/s, <= LINE_RATE_BPS) and a burst size (bytes).
+    // Returns the flow ID, or -1 on error.
+    int            addFlow             (uint64_t rate_bps, uint32_t burst_bytes);
+
+    // Method to queue a frame (copied) on a flow. Returns false on error.
+    bool           queueFrame          (uint32_t flow, const uint32_t* frame, uint32_t len);
+
+    // Method to send all queued frames, returning the number sent
+    uint32_t       run                 (void);
+
+    // Method to send a single frame on a flow (after any already queued), once it is
+    // eligible. Returns the frame's start tick.
+    uint32_t       sendFrame           (uint32_t flow, const uint32_t* frame, uint32_t len);
+
+    // Statistics
+    flowStats_t&   getStats            (uint32_t flow) {return flows[flow].stats;};
+    void           printStats          (int node);
+
+private:
+
+    // --------------------------------------------
+    // Private type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        uint64_t                          rate;      // Tokens added per tick (== bits/s)
+        int64_t                           cap;       // Bucket size, in tokens
+        int64_t                           tokens;
+        uint32_t                          last_tick; // Tick at which tokens was last updated
+        std::deque<std::vector<uint32_t>> queue;
+        flowStats_t                       stats;
+    } flow_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Method to add the tokens accrued by a flow up to a tick
+    void           refill              (flow_t &f, uint32_t tick);
+
+    // Method to return the number of ticks until a flow can afford its next frame
+    uint64_t       ticksToEligible     (const flow_t &f);
+
+    // Cost of a frame, in tokens
+    static int64_t cost                (uint32_t len) {return (int64_t)(len + IFG_TICKS) * (int64_t)LINE_RATE_BPS;};
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node's transport
+    udpVProc*                          pVp;
+
+    // Flow state
+    std::vector<flow_t>                flows;
+
+    // Earliest tick the next frame may start, honouring the minimum IFG
+    uint32_t                           next_tx_tick;
+    bool                               started;
+
+    // Start tick of the last frame sent
+    uint32_t                           last_start_tick;
+
+    // Last flow served, for round robin between equally eligible flows
+    uint32_t                           last_flow;
+};
+
+#endif
@@ -0,0 +1,99 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Lock-free single producer, single consumer ring buffer
+// template, for passing data between a worker thread and a
+// VProc node's user thread.
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_SPSC_RING_H_
+#define _UDP_SPSC_RING_H_
+
+#include <stdint.h>
+#include <atomic>
+
+// -------------------------------------------------------------
+// The ring has a power of two number of slots, ENTRIES. Slots
+// are reserved and then committed, so that large entries can be
+// built in place without a copy. Only the producer may call
+// the producer methods, and only the consumer the consumer
+// methods.
+// -------------------------------------------------------------
+
+template <typename T, uint32_t ENTRIES> class udpSpscRing
+{
+    static_assert(ENTRIES && !(ENTRIES & (ENTRIES-1)), "udpSpscRing ENTRIES must be a power of 2");
+
+public:
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpSpscRing() : head(0), tail(0) {};
+
+    // --------------------------------------------
+    // Producer methods
+    // --------------------------------------------
+
+    // Return a pointer to the next free slot, or NULL if full
+    T*       reserve () {return ((head.load(std::memory_order_relaxed) - tail.load(std::memory_order_acquire)) == ENTRIES) ?
+                                NULL : &slots[head.load(std::memory_order_relaxed) & (ENTRIES-1)];};
+
+    // Make the reserved slot visible to the consumer
+    void     commit  () {head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);};
+
+    // Copy an entry into the ring, returning false if full
+    bool     push    (const T& entry) {T* slot = reserve(); if (slot == NULL) return false; *slot = entry; commit(); return true;};
+
+    // --------------------------------------------
+    // Consumer methods
+    // --------------------------------------------
+
+    // Return a pointer to the oldest committed slot, or NULL if empty
+    T*       front   () {return (tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire)) ?
+                                NULL : &slots[tail.load(std::memory_order_relaxed) & (ENTRIES-1)];};
+
+    // Release the slot returned by front() back to the producer
+    void     release () {tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);};
+
+    // Copy the oldest entry out of the ring, returning false if empty
+    bool     pop     (T& entry) {T* slot = front(); if (slot == NULL) return false; entry = *slot; release(); return true;};
+
+    // --------------------------------------------
+    // Status methods (approximate if called by
+    // the other thread)
+    // --------------------------------------------
+
+    bool     empty   () {return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);};
+    uint32_t size    () {return head.load(std::memory_order_acquire) -  tail.load(std::memory_order_acquire);};
+    uint32_t capacity() {return ENTRIES;};
+
+private:
+
+    // Producer and consumer indexes, on separate cache lines
+    alignas(64) std::atomic<uint32_t> head;
+    alignas(64) std::atomic<uint32_t> tail;
+
+    // Ring storage
+    alignas(64) T                     slots[ENTRIES];
+};
+
+#endif
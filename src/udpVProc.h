@@ -26,13 +26,24 @@
 #define _UDP_VPROC_H_
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdint.h>
+#include <vector>
+#include <algorithm>
 
-extern "C" {
-#include "VUser.h"
-}
+#include "udpFaultInject.h"
+#include "udpLog.h"
+#include "udpProfile.h"
+#include "udpVpTransport.h"
 
-class udpVProc
+// -------------------------------------------------------------
+// The node's Ethernet engine, parameterised on the transport
+// policy used to access the udpClient HDL (see
+// udpVpTransport.h). The node code uses udpVProc, with the
+// transport selected at build time.
+// -------------------------------------------------------------
+
+template <class transport_t> class udpVProcT : public udpVpRegs
 {
 
 protected :
@@ -43,17 +54,28 @@ protected :
     // The VProc node for the udpClient HDL model
     int              node;
 
+    // Integrity state for the frame passed to processFrame(), accumulated
+    // as each byte arrived. The IPv4 and UDP sums are unfolded 16 bit word
+    // sums, with the UDP sum excluding the IPv4 pseudo-header.
+    bool             rx_crc_good;
+    uint32_t         rx_ipv4_hdr_sum;
+    uint32_t         rx_udp_sum;
+
+#ifdef UDP_PROFILE
+    // Node's hot path profile
+    udpProfile       prof;
+#endif
+
 public:
 
     // --------------------------------------------
     // Static constants
     // --------------------------------------------
 
-    // udpClient VProc address offsets
-    static const uint32_t TXD_ADDR             = 0;
-    static const uint32_t TXC_ADDR             = 1;
-    static const uint32_t TICKS_ADDR           = 2;
-    static const uint32_t HALT_ADDR            = 3;
+    // Wide mode lane parameters. Each lane has LANE_CTRL_BITS of
+    // control in the WTXC register, with the TX/RX_xxx_MASK meanings.
+    static const uint32_t MAX_LANES            = 8;
+    static const uint32_t LANE_CTRL_BITS       = 2;
     
     // Ethernet tags and frame delimeters
     static const uint32_t IDLE                 = 0x07;
@@ -62,12 +84,23 @@ public:
     static const uint32_t PREAMBLE             = 0x55;
     static const uint32_t SFD                  = 0xd5;
     
-    static const uint32_t RX_VALID_MASK        = 0x01;
-    static const uint32_t RX_ERROR_MASK        = 0x02;
     static const uint32_t TX_ERROR_MASK        = 0x100;
-    static const uint32_t TX_CTRL_IDLE         = 0x00;
-    static const uint32_t TX_CTRL_VALID        = 0x01;
-    static const uint32_t TX_CTRL_ERROR        = 0x03;
+
+    // Receive wait timeout value to wait indefinitely
+    static const uint32_t RX_WAIT_FOREVER      = 0xffffffff;
+
+    // Waveform trace window trigger events
+    static const uint32_t TRACE_TRIG_BAD_CRC   = 0x1;  // Received frame with bad FCS
+    static const uint32_t TRACE_TRIG_RX_ERR    = 0x2;  // Received frame with RX_ER asserted
+    static const uint32_t TRACE_TRIG_REJECT    = 0x4;  // Received frame rejected by processFrame()
+    static const uint32_t TRACE_NO_TICK        = 0xffffffff;
+
+    // Raw frame callback rejection status
+    static const uint32_t RAW_RX_BAD_CRC       = 0x1;
+
+    // TX descriptor ring size (power of 2), and the gap between posted frames (96 bit times)
+    static const uint32_t TX_RING_SIZE         = 64;
+    static const uint32_t TX_RING_IFG_TICKS    = 12;
 
     // Ethernet parameters and header dimensions
     static const uint32_t ETH_MTU              = 1500;
@@ -75,16 +108,125 @@ public:
     static const uint32_t ETH_802_1Q_LEN       = 4;  // BYTES
     static const uint32_t ETH_CRC_LEN          = 4;  // BYTES
     static const uint32_t ETH_HDR_LEN          = 14; // BYTES
+    static const uint32_t ETH_MIN_FRAME_LEN    = 64; // BYTES, including FCS
+    static const uint32_t ETH_TYPE_IPV4        = 0x0800;
+
+    // MAC control (802.3x PAUSE and 802.1Qbb PFC) parameters. A pause quantum is 512 bit
+    // times, which is 64 ticks of the byte wide interface.
+    static const uint32_t ETH_TYPE_MAC_CTRL    = 0x8808;
+    static const uint64_t MAC_CTRL_ADDR        = 0x0180c2000001ULL;
+    static const uint32_t MAC_CTRL_PAUSE       = 0x0001; // Opcodes
+    static const uint32_t MAC_CTRL_PFC         = 0x0101;
+    static const uint32_t PAUSE_QUANTUM_TICKS  = 64;
+    static const uint32_t PFC_PRIORITIES       = 8;
+
+    // CRC32 parameters
+    static const uint32_t POLY                 = 0xEDB88320;  /* 0x04C11DB7 bit reversed */
+    static const uint32_t INIT                 = 0xFFFFFFFF;
+    static const uint32_t CRC_RESIDUE          = 0xDEBB20E3;  /* Running CRC over frame and good FCS */
+
+    // IPv4 header offsets used by the streaming receive checks
+    static const uint32_t RX_IPV4_IHL_OFFSET   = ETH_HDR_LEN;     // BYTES
+    static const uint32_t RX_IPV4_LEN_OFFSET   = ETH_HDR_LEN + 2; // BYTES
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Raw received frame callback
+    typedef void (*pRawRxCbFunc_t) (const uint32_t* frame, uint32_t len, void* hdl);
+
+    // TX descriptor ring completion, and its callback. In wide mode, ticks are to
+    // the nearest TX word.
+    typedef struct {
+        uint32_t*  frame;             // As posted
+        uint32_t   len;
+        void*      tag;               // As posted
+        uint32_t   start_tick;        // Tick of the first byte
+        uint32_t   end_tick;          // Tick after the last byte
+    } txDone_t;
+
+    typedef void (*pTxDoneCbFunc_t) (const txDone_t &done, void* hdl);
+
+    // MAC control frame counts, and TX time lost to pausing
+    typedef struct {
+        uint64_t   rx_pause_frames;   // 802.3x PAUSE frames received
+        uint64_t   rx_pfc_frames;     // 802.1Qbb PFC frames received
+        uint64_t   rx_unknown;        // Other MAC control opcodes received (ignored)
+        uint64_t   tx_pause_frames;   // PAUSE frames sent
+        uint64_t   tx_pfc_frames;     // PFC frames sent
+        uint64_t   pause_events;      // Frames held back by a pause
+        uint64_t   paused_ticks;      // Ticks spent holding back frames
+    } pauseStats_t;
 
     // --------------------------------------------
     // Constructor
     // --------------------------------------------
 
-    udpVProc(int nodeIn) : node(nodeIn)
+    udpVProcT(int nodeIn) : node(nodeIn), vp(nodeIn)
     {
         currTickCount                  = 0xffffffff;
         receiving_frame                = false;
+        rx_error_detected              = false;
+        rx_in_preamble                 = false;
         rx_idx                         = 0;
+        rx_good_count                  = 0;
+        rx_last_tick                   = 0;
+
+        pFault                         = NULL;
+        pRawRxCbFunc                   = NULL;
+        raw_rx_hdl                     = NULL;
+
+        crc_table                      = UdpVpCrcTable();
+        rx_crc_good                    = false;
+        rx_ipv4_hdr_sum                = 0;
+        rx_udp_sum                     = 0;
+
+        trace_on                       = false;
+        trace_end                      = 0;
+        trace_next_tick                = TRACE_NO_TICK;
+        trace_win_idx                  = 0;
+        trace_trig_mask                = 0;
+        trace_pre                      = 0;
+        trace_post                     = 0;
+        trace_trig_fp                  = NULL;
+
+        lanes                          = 0;
+        tx_lane_idx                    = 0;
+        tx_lane_lo                     = 0;
+        tx_lane_hi                     = 0;
+        tx_lane_ctl                    = 0;
+
+        tx_priority                    = 0;
+        pause_until                    = 0;
+        pause_active                   = 0;
+
+        for (uint32_t pri = 0; pri < PFC_PRIORITIES; pri++)
+        {
+            pfc_until[pri]             = 0;
+        }
+
+        pause_stats                    = {0, 0, 0, 0, 0, 0, 0};
+
+        tx_ring_head                   = 0;
+        tx_ring_tail                   = 0;
+        tx_ring_busy                   = false;
+        tx_ring_held                   = false;
+        tx_ring_frame                  = NULL;
+        tx_ring_len                    = 0;
+        tx_ring_idx                    = 0;
+        tx_ring_end                    = 0;
+        tx_ring_ifg                    = 0;
+        pTxDoneCbFunc                  = NULL;
+        tx_done_hdl                    = NULL;
+    };
+
+    ~udpVProcT()
+    {
+        if (trace_trig_fp != NULL)
+        {
+            fclose(trace_trig_fp);
+        }
     };
 
     // --------------------------------------------------
@@ -94,60 +236,732 @@ public:
     uint32_t UdpVpSendIdle(uint32_t ticks)
     {
         uint32_t error = 0;
-        uint32_t currTicks;
 
-        VWrite(TXD_ADDR, IDLE,         true, node);
-        VWrite(TXC_ADDR, TX_CTRL_IDLE, true, node);
+        // Send any posted frames in place of idle
+        if (UdpVpTxRingActive())
+        {
+            if (UdpVpGetLanes() == 1)
+            {
+                UdpVpWrite(TXD_ADDR, IDLE,         true);
+                UdpVpWrite(TXC_ADDR, TX_CTRL_IDLE, true);
+            }
+
+            for (uint32_t idx = 0; idx < ticks; idx++)
+            {
+                UdpVpTxRingTick();
+            }
 
-        // Get start time
-        for (int idx = 0; idx < ticks; idx++)
+            return error;
+        }
+
+        if (UdpVpGetLanes() > 1)
         {
-            VRead(TICKS_ADDR, &currTicks, true, node);
+            for (uint32_t idx = 0; idx < ticks; idx++)
+            {
+                UdpVpTxLane(IDLE, TX_CTRL_IDLE);
+            }
+
+            return error;
+        }
+
+        UdpVpWrite(TXD_ADDR, IDLE,         true);
+        UdpVpWrite(TXC_ADDR, TX_CTRL_IDLE, true);
 
+        // Extract RX data and advance tick
+        for (int idx = 0; idx < ticks; idx++)
+        {
             UdpVpExtractRx();
         }
 
         return error;
     }
 
+    // --------------------------------------------------
+    // Method to idle until a frame has been received
+    // and accepted by processFrame(), or until timeout
+    // ticks have passed (RX_WAIT_FOREVER for no
+    // timeout). Returns true, with the tick at which
+    // the frame completed in tick, or false on timeout.
+    // Any tick value is a valid completion tick, so
+    // the status is kept separate from it.
+    // --------------------------------------------------
+    bool UdpVpWaitForRx(uint32_t timeoutTicks, uint32_t &tick)
+    {
+        uint32_t start_count = rx_good_count;
+        bool     wide        = UdpVpGetLanes() > 1;
+
+        if (!wide)
+        {
+            UdpVpWrite(TXD_ADDR, IDLE,         true);
+            UdpVpWrite(TXC_ADDR, TX_CTRL_IDLE, true);
+        }
+
+        for (uint32_t idx = 0; timeoutTicks == RX_WAIT_FOREVER || idx < timeoutTicks; idx++)
+        {
+            // Send any posted frames whilst waiting
+            if (UdpVpTxRingActive())
+            {
+                UdpVpTxRingTick();
+            }
+            else if (wide)
+            {
+                UdpVpTxLane(IDLE, TX_CTRL_IDLE);
+            }
+            else
+            {
+                UdpVpExtractRx();
+            }
+
+            if (rx_good_count != start_count)
+            {
+                tick = rx_last_tick;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool UdpVpWaitForRx(uint32_t timeoutTicks = RX_WAIT_FOREVER)
+    {
+        uint32_t tick;
+
+        return UdpVpWaitForRx(timeoutTicks, tick);
+    }
+
     // --------------------------------------------------
     // Method to send a pre-prepared (raw) ethernet frame
     // --------------------------------------------------
     uint32_t UdpVpSendRawEthFrame(uint32_t* frame, uint32_t len)
     {
-        uint32_t error = 0;
+        uint32_t error  = 0;
+        bool     no_ifg = false;
+
+        frame           = UdpVpTxPrepare(frame, len, no_ifg);
 
-        // Construct 64 bit TXD words and associated TXC byte from frame data,
-        // flushed to 64 bit boundary
         for (int idx = 0; idx < len; idx++)
         {
-            // Send out byte
-            VWrite(TXD_ADDR, frame[idx] & 0xff, true, node);
-            
-            // TX control bit
+            UdpVpSendFrameByte(frame, idx, len);
+        }
+
+        if (!no_ifg)
+        {
+            UdpVpSendIdle(1);
+        }
+
+        return error;
+    }
+
+    // --------------------------------------------------
+    // Method to ready a frame to be sent from the
+    // current tick. Any posted frames are sent first,
+    // to keep frames in order, all but MAC control
+    // frames are held whilst paused by the link
+    // partner, and any faults are injected. Returns the
+    // frame to send, with len updated, and no_ifg set
+    // if the gap after it is to be dropped. Callers
+    // sending a frame with UdpVpSendFrameByte() must
+    // call this before its first byte.
+    // --------------------------------------------------
+    uint32_t* UdpVpTxPrepare(uint32_t* frame, uint32_t &len, bool &no_ifg)
+    {
+        // Keep frames in order with any posted before
+        UdpVpTxFlush();
+
+        // Hold back all but MAC control frames whilst paused by the link partner
+        if (pause_active && !UdpVpIsMacCtrl(frame, len))
+        {
+            UdpVpPauseWait();
+        }
+
+        // Inject any faults into the frame, if enabled
+        if (pFault != NULL)
+        {
+            frame = pFault->apply(frame, len, UdpVpGetTicks(), no_ifg);
+        }
+
+        return frame;
+    }
+
+    // --------------------------------------------------
+    // Method to send a single byte of a pre-prepared
+    // frame, advancing by one tick. Allows callers to
+    // interleave other work between bytes of a frame.
+    // --------------------------------------------------
+    void UdpVpSendFrameByte(uint32_t* frame, uint32_t idx, uint32_t len)
+    {
+        // TX control bit
 #ifdef GENERATE_SOF_EOF
-            uint32_t txc = (frame[idx] & TX_ERROR_MASK) ? TX_CTRL_ERROR : (idx == 0 || idx == (len-1)) ? 0 : TX_CTRL_VALID;
+        uint32_t txc = (frame[idx] & TX_ERROR_MASK) ? TX_CTRL_ERROR : (idx == 0 || idx == (len-1)) ? 0 : TX_CTRL_VALID;
 #else
-            uint32_t txc = (frame[idx] & TX_ERROR_MASK) ? TX_CTRL_ERROR : TX_CTRL_VALID;
+        uint32_t txc = (frame[idx] & TX_ERROR_MASK) ? TX_CTRL_ERROR : TX_CTRL_VALID;
 #endif
-            VWrite(TXC_ADDR, txc, true, node);
 
-            // Extract RX data and advance tick
-            UdpVpExtractRx();
+        // In wide mode, add the byte to the next TX word
+        if (UdpVpGetLanes() > 1)
+        {
+            UdpVpTxLane(frame[idx] & 0xff, txc);
+            return;
         }
 
-        UdpVpSendIdle(1);
+        // Send out byte
+        UdpVpWrite(TXD_ADDR, frame[idx] & 0xff, true);
+        UdpVpWrite(TXC_ADDR, txc, true);
 
-        return error;
+        // Extract RX data and advance tick
+        UdpVpExtractRx();
+    }
+
+    // --------------------------------------------------
+    // Method to post a frame on the TX descriptor ring,
+    // returning at once. Posted frames are sent in
+    // order, TX_RING_IFG_TICKS apart, in place of idle
+    // in UdpVpSendIdle() and UdpVpWaitForRx(). The
+    // frame buffer must be left unchanged until the
+    // frame's completion. Returns false if the ring is
+    // full.
+    // --------------------------------------------------
+    bool UdpVpTxPost(uint32_t* frame, uint32_t len, void* tag = NULL)
+    {
+        if (len == 0 || tx_ring_head - tx_ring_tail == TX_RING_SIZE)
+        {
+            return false;
+        }
+
+        txDesc_t &d                    = tx_ring[tx_ring_head++ & (TX_RING_SIZE-1)];
+
+        d.frame                        = frame;
+        d.len                          = len;
+        d.tag                          = tag;
+
+        return true;
+    }
+
+    // --------------------------------------------------
+    // Method to register a callback for the completion
+    // of each posted frame, called from the node's
+    // thread as the last byte is sent. The callback may
+    // post further frames, but must not advance the
+    // node.
+    // --------------------------------------------------
+    void UdpVpRegisterTxDoneCb(pTxDoneCbFunc_t pFunc, void* hdlIn) {pTxDoneCbFunc = pFunc; tx_done_hdl = hdlIn;}
+
+    // --------------------------------------------------
+    // Method to return the number of posted frames not
+    // yet completed
+    // --------------------------------------------------
+    uint32_t UdpVpTxPending() {return tx_ring_head - tx_ring_tail;}
+
+    // --------------------------------------------------
+    // Method to send all posted frames, and the gap
+    // after the last
+    // --------------------------------------------------
+    void UdpVpTxFlush()
+    {
+        if (!UdpVpTxRingActive())
+        {
+            return;
+        }
+
+        if (UdpVpGetLanes() == 1)
+        {
+            UdpVpWrite(TXD_ADDR, IDLE,         true);
+            UdpVpWrite(TXC_ADDR, TX_CTRL_IDLE, true);
+        }
+
+        while (UdpVpTxRingActive() || !UdpVpTxRingGapDone())
+        {
+            UdpVpTxRingTick();
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to get the current clock tick count
+    // --------------------------------------------------
+    uint32_t UdpVpGetTicks()
+    {
+        if (currTickCount == 0xffffffff)
+        {
+            UdpVpRead(TICKS_ADDR, &currTickCount, true);
+        }
+
+        return currTickCount;
     }
     
     // --------------------------------------------------
-    // Method to set the halt output signal
+    // Method to attach a fault injection engine to the
+    // TX path (NULL to disable)
+    // --------------------------------------------------
+    void UdpVpSetFaultInject(udpFaultInject* pFaultIn) {pFault = pFaultIn;}
+
+    // --------------------------------------------------
+    // Method to register a callback for all received
+    // frames with a good FCS, bypassing processFrame()
+    // (NULL to restore normal processing). Frames are
+    // passed one byte per word, from the destination
+    // address to the end of the FCS.
+    // --------------------------------------------------
+    void UdpVpRegisterRawRxCb(pRawRxCbFunc_t pFunc, void* hdlIn) {pRawRxCbFunc = pFunc; raw_rx_hdl = hdlIn;}
+
+    // --------------------------------------------------
+    // Methods to record the node's VProc transactions
+    // to a file, or replay them from one without the
+    // HDL (see udpVpRecord), before the node's first
+    // access. Only available with the recording and
+    // replay transports respectively, which also start
+    // from the UDP_RECORD and UDP_REPLAY environment
+    // variables (see udpVpTransport.h).
+    // --------------------------------------------------
+    bool UdpVpRecord(const char* fname) {return vp.record(fname);}
+    bool UdpVpReplay(const char* fname) {return vp.replay(fname);}
+
+    // --------------------------------------------------
+    // Methods to set the priority (0 to 7) of the
+    // node's TX frames, for the purposes of PFC, and
+    // to access the MAC control counts
+    // --------------------------------------------------
+    void UdpVpSetTxPriority(uint32_t pri) {tx_priority = pri % PFC_PRIORITIES;}
+
+    pauseStats_t& UdpVpGetPauseStats() {return pause_stats;}
+
+    // --------------------------------------------------
+    // Method to return the ticks until the node's TX
+    // is no longer paused by the link partner (by
+    // PAUSE, or by PFC for the TX priority), or 0 if
+    // not paused
+    // --------------------------------------------------
+    uint32_t UdpVpTxPauseTicks()
+    {
+        if (!pause_active)
+        {
+            return 0;
+        }
+
+        uint32_t now                   = UdpVpGetTicks();
+        uint32_t pfc_bit               = 1 << (tx_priority + 1);
+        int32_t  pause_left            = (int32_t)(pause_until - now);
+        int32_t  pfc_left              = (int32_t)(pfc_until[tx_priority] - now);
+
+        // Drop pauses that have expired
+        if ((pause_active & 1) && pause_left <= 0)
+        {
+            pause_active               &= ~1;
+        }
+
+        if ((pause_active & pfc_bit) && pfc_left <= 0)
+        {
+            pause_active               &= ~pfc_bit;
+        }
+
+        return std::max((pause_active & 1)       ? pause_left : 0,
+                        (pause_active & pfc_bit) ? pfc_left   : 0);
+    }
+
+    // --------------------------------------------------
+    // Method to set the halt output signal, first
+    // completing any partial wide mode TX word (and,
+    // when profiling, printing the node's profile)
+    // --------------------------------------------------
+    void UdpVpSetHalt(uint32_t val)
+    {
+        UdpVpFlush();
+
+#ifdef UDP_PROFILE
+        if (val & 0x1)
+        {
+            prof.print(node, UdpVpGetTicks());
+        }
+#endif
+
+        UdpVpWrite(HALT_ADDR, val & 0x1, false);
+    }
+
+    // --------------------------------------------------
+    // Method to return the number of byte lanes per
+    // HDL access: 1 for the byte wide interface, or
+    // the width of a wide mode model, which is read
+    // from the HDL on first use.
+    // --------------------------------------------------
+    uint32_t UdpVpGetLanes()
+    {
+        if (lanes == 0)
+        {
+            UdpVpRead(LANES_ADDR, &lanes, true);
+
+            if (lanes == 0 || lanes > MAX_LANES)
+            {
+                printf("NODE%d: UdpVpGetLanes() : ***ERROR. Invalid number of lanes (%d) from HDL. Using 1\n", node, lanes);
+                lanes                  = 1;
+            }
+        }
+
+        return lanes;
+    }
+
+    // --------------------------------------------------
+    // Method to complete any partial wide mode TX word
+    // with idle lanes, and send it
+    // --------------------------------------------------
+    void UdpVpFlush()
+    {
+        while (tx_lane_idx != 0)
+        {
+            UdpVpTxLane(IDLE, TX_CTRL_IDLE);
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to turn waveform dumping on or off, when
+    // the test bench has VCD_DUMP=2
+    // --------------------------------------------------
+    void UdpVpSetTrace(bool on)
+    {
+        if (on != trace_on)
+        {
+            UdpVpWrite(TRACE_ADDR, on ? 1 : 0, true);
+            trace_on                   = on;
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to schedule a waveform dump window, from
+    // start tick up to (but not including) end tick
+    // --------------------------------------------------
+    void UdpVpAddTraceWindow(uint32_t start, uint32_t end)
+    {
+        traceWindow_t win              = {start, end};
+
+        // Keep the pending windows sorted by start tick
+        trace_windows.insert(std::upper_bound(trace_windows.begin() + trace_win_idx, trace_windows.end(), win,
+                                              [](const traceWindow_t &a, const traceWindow_t &b) {return a.start < b.start;}),
+                             win);
+
+        UdpVpTraceUpdate();
+    }
+
+    // --------------------------------------------------
+    // Method to open dump windows around trigger events
+    // (TRACE_TRIG_xxx mask), from pre ticks before the
+    // event to post ticks after it.
+    //
+    // Windows can't go back in time, so, if trigfile is
+    // given, event ticks are appended to it on the first
+    // run, with only the post event window dumped. On a
+    // rerun (with the same seed) the file is read back
+    // and the full windows are dumped.
+    // --------------------------------------------------
+    void UdpVpSetTraceTrigger(uint32_t mask, uint32_t pre, uint32_t post, const char* trigfile = NULL)
+    {
+        FILE* fp;
+
+        trace_trig_mask                = mask;
+        trace_pre                      = pre;
+        trace_post                     = post;
+
+        if (trigfile != NULL && (fp = fopen(trigfile, "r")) != NULL)
+        {
+            uint32_t tick;
+
+            while (fscanf(fp, "%u", &tick) == 1)
+            {
+                UdpVpAddTraceWindow((tick > pre) ? tick - pre : 0, tick + post);
+            }
+            fclose(fp);
+        }
+        else if (trigfile != NULL && (trace_trig_fp = fopen(trigfile, "w")) == NULL)
+        {
+            printf("NODE%d: UdpVpSetTraceTrigger() : ***ERROR. Unable to open %s for writing\n", node, trigfile);
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to signal a trigger event at the current
+    // tick. Called for the TRACE_TRIG_xxx events, and
+    // may be called by test code for its own.
     // --------------------------------------------------
-    void UdpVpSetHalt(uint32_t val) {VWrite(HALT_ADDR, val & 0x1, false, node);}
+    void UdpVpTraceEvent()
+    {
+        uint32_t tick                  = UdpVpGetTicks();
+
+        if (trace_trig_fp != NULL)
+        {
+            fprintf(trace_trig_fp, "%u\n", tick);
+            fflush(trace_trig_fp);
+        }
+
+        UdpVpAddTraceWindow(tick, tick + trace_post);
+    }
+
+    // --------------------------------------------------
+    // Method to return the byte-wise CRC32 lookup table,
+    // constructed on first use.
+    // --------------------------------------------------
+    static const uint32_t* UdpVpCrcTable()
+    {
+        static const struct crcTable_t
+        {
+            uint32_t entry[256];
+
+            crcTable_t()
+            {
+                for (uint32_t idx = 0; idx < 256; idx++)
+                {
+                    uint32_t val = idx;
+                    for (int bit = 0; bit < 8; bit++)
+                    {
+                        val = (val & 1) ? (val >> 1) ^ POLY : val >> 1;
+                    }
+                    entry[idx] = val;
+                }
+            }
+        } table;
+
+        return table.entry;
+    }
     
 private:
 
+    // --------------------------------------------------
+    // Method to check whether a TX frame (with any SOF,
+    // preamble and SFD) is a MAC control frame
+    // --------------------------------------------------
+    bool UdpVpIsMacCtrl(const uint32_t* frame, uint32_t len)
+    {
+        uint32_t idx                   = 0;
+
+        // Skip to the end of the preamble
+        while (idx < len && idx <= ETH_PREAMBLE && (frame[idx] & 0xff) != SFD)
+        {
+            idx++;
+        }
+
+        idx                            += 1 + 12;
+
+        return idx + 1 < len && (((frame[idx] & 0xff) << 8) | (frame[idx+1] & 0xff)) == ETH_TYPE_MAC_CTRL;
+    }
+
+    // --------------------------------------------------
+    // Method to idle until TX is no longer paused. The
+    // pause is checked at least every quantum, so that
+    // a new PAUSE frame extending or cancelling it
+    // takes effect.
+    // --------------------------------------------------
+    void UdpVpPauseWait()
+    {
+        uint32_t ticks                 = UdpVpTxPauseTicks();
+
+        if (ticks == 0)
+        {
+            return;
+        }
+
+        uint32_t start                 = UdpVpGetTicks();
+
+        pause_stats.pause_events++;
+
+        while (ticks)
+        {
+            UdpVpSendIdle(ticks < PAUSE_QUANTUM_TICKS ? ticks : PAUSE_QUANTUM_TICKS);
+            ticks                      = UdpVpTxPauseTicks();
+        }
+
+        pause_stats.paused_ticks       += UdpVpGetTicks() - start;
+    }
+
+    // --------------------------------------------------
+    // Methods for the TX descriptor ring state: posted
+    // frames waiting or being sent, and whether the
+    // gap after the last frame sent has passed
+    // --------------------------------------------------
+    bool UdpVpTxRingActive()  {return tx_ring_head != tx_ring_tail;}
+    bool UdpVpTxRingGapDone() {return UdpVpGetTicks() - tx_ring_end >= tx_ring_ifg;}
+
+    // --------------------------------------------------
+    // Method to advance the node by one tick, sending
+    // the next byte of a posted frame, or idle. The wire
+    // is left idle after the last byte, so that the
+    // callers' own idle loops may follow.
+    // --------------------------------------------------
+    void UdpVpTxRingTick()
+    {
+        txDesc_t &d                    = tx_ring[tx_ring_tail & (TX_RING_SIZE-1)];
+
+        // Start the next frame once the gap has passed, and if not paused by the link partner
+        if (!tx_ring_busy && UdpVpTxRingActive() && UdpVpTxRingGapDone())
+        {
+            if (pause_active && !UdpVpIsMacCtrl(d.frame, d.len) && UdpVpTxPauseTicks())
+            {
+                if (!tx_ring_held)
+                {
+                    pause_stats.pause_events++;
+                    tx_ring_held       = true;
+                }
+                pause_stats.paused_ticks++;
+            }
+            else
+            {
+                bool no_ifg            = false;
+
+                tx_ring_held           = false;
+                tx_ring_frame          = d.frame;
+                tx_ring_len            = d.len;
+                tx_ring_idx            = 0;
+                d.start_tick           = UdpVpGetTicks();
+
+                if (pFault != NULL)
+                {
+                    tx_ring_frame      = pFault->apply(d.frame, tx_ring_len, d.start_tick, no_ifg);
+                }
+
+                tx_ring_ifg            = no_ifg ? 0 : TX_RING_IFG_TICKS;
+                tx_ring_busy           = true;
+            }
+        }
+
+        if (!tx_ring_busy)
+        {
+            if (UdpVpGetLanes() > 1)
+            {
+                UdpVpTxLane(IDLE, TX_CTRL_IDLE);
+            }
+            else
+            {
+                UdpVpExtractRx();
+            }
+            return;
+        }
+
+        UdpVpSendFrameByte(tx_ring_frame, tx_ring_idx++, tx_ring_len);
+
+        if (tx_ring_idx == tx_ring_len)
+        {
+            if (UdpVpGetLanes() == 1)
+            {
+                UdpVpWrite(TXD_ADDR, IDLE,         true);
+                UdpVpWrite(TXC_ADDR, TX_CTRL_IDLE, true);
+            }
+
+            txDone_t done              = {d.frame, d.len, d.tag, d.start_tick, UdpVpGetTicks()};
+
+            tx_ring_end                = done.end_tick;
+            tx_ring_busy               = false;
+            tx_ring_tail++;
+
+            if (pTxDoneCbFunc != NULL)
+            {
+                (*pTxDoneCbFunc)(done, tx_done_hdl);
+            }
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to act on a received MAC control frame
+    // (EtherType 0x8808, with a good FCS). PAUSE sets
+    // the time all TX is paused until, and PFC the time
+    // each enabled priority is paused until, with a
+    // time of 0 cancelling a pause. The node is taken
+    // to be on a point-to-point link, so the
+    // destination address is not checked.
+    // --------------------------------------------------
+    void UdpVpMacCtrlRx(const uint32_t* frame, uint32_t len)
+    {
+        uint32_t idx                   = ETH_HDR_LEN;
+        uint32_t now                   = UdpVpGetTicks();
+        uint32_t opcode                = (frame[idx] << 8) | frame[idx+1];
+
+        idx                            += 2;
+
+        if (opcode == MAC_CTRL_PAUSE)
+        {
+            uint32_t quanta            = (frame[idx] << 8) | frame[idx+1];
+
+            pause_until                = now + quanta * PAUSE_QUANTUM_TICKS;
+            pause_active               |= 1;
+            pause_stats.rx_pause_frames++;
+
+            UDP_LOG(node, now, udpLog::LOG_DEBUG, "NODE%d: received PAUSE for %d quanta\n", node, quanta);
+        }
+        else if (opcode == MAC_CTRL_PFC)
+        {
+            uint32_t enable            = (frame[idx] << 8) | frame[idx+1];
+
+            for (uint32_t pri = 0; pri < PFC_PRIORITIES; pri++)
+            {
+                if (enable & (1 << pri))
+                {
+                    uint32_t tidx      = idx + 2 + 2*pri;
+                    uint32_t quanta    = (frame[tidx] << 8) | frame[tidx+1];
+
+                    pfc_until[pri]     = now + quanta * PAUSE_QUANTUM_TICKS;
+                    pause_active       |= 1 << (pri + 1);
+                }
+            }
+
+            pause_stats.rx_pfc_frames++;
+
+            UDP_LOG(node, now, udpLog::LOG_DEBUG, "NODE%d: received PFC for priorities 0x%02x\n", node, enable & 0xff);
+        }
+        else
+        {
+            pause_stats.rx_unknown++;
+        }
+    }
+
+    // --------------------------------------------------
+    // Methods for all HDL accesses by the node, through
+    // the transport
+    // --------------------------------------------------
+    void UdpVpWrite (uint32_t addr, uint32_t data, bool delta)
+    {
+        UDP_PROF_SCOPE(prof, PROF_VPROC);
+
+        vp.write(addr, data, delta);
+    }
+
+    void UdpVpRead (uint32_t addr, uint32_t* data, bool delta)
+    {
+        UDP_PROF_SCOPE(prof, PROF_VPROC);
+
+        vp.read(addr, data, delta);
+    }
+
+    // --------------------------------------------------
+    // Method to update the receive integrity state with
+    // a new frame byte (at rx_idx, after the SFD).
+    // --------------------------------------------------
+    void UdpVpAccumRxByte (uint32_t rxbyte)
+    {
+        // Running CRC over everything after the SFD, including the FCS,
+        // so a good frame leaves the CRC_RESIDUE value
+        rx_crc                         = crc_table[(rx_crc ^ rxbyte) & 0xff] ^ (rx_crc >> 8);
+
+        // Pick up the IPv4 header and total lengths as they go past
+        if (rx_idx == RX_IPV4_IHL_OFFSET)
+        {
+            rx_ipv4_hdr_end            = ETH_HDR_LEN + (rxbyte & 0xf)*4;
+        }
+        else if (rx_idx == RX_IPV4_LEN_OFFSET+1)
+        {
+            rx_ipv4_end                = ETH_HDR_LEN + ((rx_buf[RX_IPV4_LEN_OFFSET] << 8) | rxbyte);
+        }
+
+        // Add byte to the relevant 16 bit word sum. Even offsets from the IPv4
+        // header start are the high byte of a word.
+        if (rx_idx >= ETH_HDR_LEN)
+        {
+            uint32_t word_byte         = ((rx_idx - ETH_HDR_LEN) & 1) ? rxbyte : rxbyte << 8;
+
+            if (rx_idx < rx_ipv4_hdr_end)
+            {
+                rx_ipv4_sum            += word_byte;
+            }
+            else if (rx_idx < rx_ipv4_end)
+            {
+                rx_udp_sum_int         += word_byte;
+            }
+        }
+    }
+
     // --------------------------------------------------
     // Method to extract received data from VProc input
     // interface.
@@ -155,34 +969,115 @@ private:
     void UdpVpExtractRx ()
     {
         uint32_t rxd, rxc;
-        uint32_t clk_count;
-        bool     error_detected;
 
+        UdpVpNextTick();
+
+        // Read the input pins: the 8 bits of data and 2 of control
+        UdpVpRead(TXD_ADDR, &rxd,     true);
+        UdpVpRead(TXC_ADDR, &rxc,     false);
+
+        UdpVpRxByte(rxd & 0xff, rxc);
+    }
+
+    // --------------------------------------------------
+    // Method to add a byte and its control bits to the
+    // wide mode TX word. When the word is full, it is
+    // sent and the received word read back, with each
+    // RX lane processed in turn.
+    // --------------------------------------------------
+    void UdpVpTxLane (uint32_t txd, uint32_t txc)
+    {
+        if (tx_lane_idx < 4)
+        {
+            tx_lane_lo                 |= (txd & 0xff) << (8*tx_lane_idx);
+        }
+        else
+        {
+            tx_lane_hi                 |= (txd & 0xff) << (8*(tx_lane_idx-4));
+        }
+
+        tx_lane_ctl                    |= (txc & 0x3) << (LANE_CTRL_BITS*tx_lane_idx);
+
+        if (++tx_lane_idx < lanes)
+        {
+            return;
+        }
+
+        uint32_t rxlo, rxhi = 0, rxc;
+
+        // Write the TX word, and read the received word, advancing the clock
+        UdpVpWrite(WTXD_ADDR, tx_lane_lo, true);
+        if (lanes > 4)
+        {
+            UdpVpWrite(WTXD_HI_ADDR, tx_lane_hi, true);
+        }
+        UdpVpWrite(WTXC_ADDR, tx_lane_ctl, true);
+
+        UdpVpRead(WTXD_ADDR, &rxlo, true);
+        if (lanes > 4)
+        {
+            UdpVpRead(WTXD_HI_ADDR, &rxhi, true);
+        }
+        UdpVpRead(WTXC_ADDR, &rxc, false);
+
+        tx_lane_idx                    = 0;
+        tx_lane_lo                     = 0;
+        tx_lane_hi                     = 0;
+        tx_lane_ctl                    = 0;
+
+        // Process the received lanes, first on the wire first
+        for (uint32_t lane = 0; lane < lanes; lane++)
+        {
+            UdpVpNextTick();
+            UdpVpRxByte(((lane < 4 ? rxlo >> (8*lane) : rxhi >> (8*(lane-4)))) & 0xff,
+                        (rxc >> (LANE_CTRL_BITS*lane)) & 0x3);
+        }
+    }
+
+    // --------------------------------------------------
+    // Method to advance the tick count for each byte
+    // received, and update any waveform dump windows
+    // --------------------------------------------------
+    void UdpVpNextTick ()
+    {
         // If the current tick count is uninitialised, fetch clock tick count from the HDL,
         // else increment for each read cycle.
         if (currTickCount == 0xffffffff)
         {
-            VRead(TICKS_ADDR, &currTickCount, true, node);
+            UdpVpRead(TICKS_ADDR, &currTickCount, true);
         }
         else
         {
             currTickCount++;
         }
 
-        // Read the input pins: the 8 bits of data and 2 of control
-        VRead(TXD_ADDR, &rxd,     true,  node);
-        VRead(TXC_ADDR, &rxc,     false, node);
-
-        // Extract the data byte, with bit 8 as the control bit
-        uint32_t rxbyte = rxd & 0xff;
+        // Open or close waveform dump windows
+        if (currTickCount == trace_next_tick)
+        {
+            UdpVpTraceUpdate();
+        }
+    }
 
+    // --------------------------------------------------
+    // Method to process a received byte and its
+    // control bits
+    // --------------------------------------------------
+    void UdpVpRxByte (uint32_t rxbyte, uint32_t rxc)
+    {
         // If not receiving a frame already, and a new frame detected,
-        // flag receiving and reset the RX buffer index
+        // flag receiving and reset the RX buffer index and integrity state
         if (!receiving_frame && (rxc & RX_VALID_MASK))
         {
-            receiving_frame = true;
-            error_detected  = false;
-            rx_idx          = 0;
+            receiving_frame            = true;
+            rx_error_detected          = false;
+            rx_in_preamble             = true;
+            rx_idx                     = 0;
+
+            rx_crc                     = INIT;
+            rx_ipv4_sum                = 0;
+            rx_udp_sum_int             = 0;
+            rx_ipv4_hdr_end            = ETH_HDR_LEN;
+            rx_ipv4_end                = 0;
         }
 
         // If receving a frame...
@@ -192,40 +1087,133 @@ private:
             // method to process the data,
             if (!(rxc & RX_VALID_MASK))
             {
-                receiving_frame = false;
-                
-                // Calculate length of preamble and SFD (could be variable)
-                int pidx = 0;
-                while (rx_buf[pidx] == PREAMBLE || rx_buf[pidx] == SFD)
+                receiving_frame        = false;
+
+                uint32_t trig          = rx_error_detected ? TRACE_TRIG_RX_ERR : 0;
+
+                // Process input if no errors were seen
+                if (!rx_error_detected)
                 {
-                    pidx++;
+                    // Integrity checks already accumulated, so just latch the results
+                    rx_crc_good        = rx_idx >= ETH_CRC_LEN && rx_crc == CRC_RESIDUE;
+                    rx_ipv4_hdr_sum    = rx_ipv4_sum;
+                    rx_udp_sum         = rx_udp_sum_int;
+
+                    // MAC control frames are consumed here, and not passed on. They are
+                    // minimum size, so a short one is not acted on, as its PFC class
+                    // times would be read from beyond its end.
+                    if (rx_crc_good && rx_idx >= ETH_MIN_FRAME_LEN &&
+                        ((rx_buf[12] << 8) | rx_buf[13]) == ETH_TYPE_MAC_CTRL)
+                    {
+                        UdpVpMacCtrlRx(rx_buf, rx_idx);
+                    }
+                    else
+                    {
+                        // Process input, the Premable and SFD having been stripped on arrival,
+                        // and note the completion tick of frames accepted. With a raw frame
+                        // callback registered, frames with a good FCS go to it instead.
+                        uint32_t status = (pRawRxCbFunc == NULL) ? processFrame(rx_buf, rx_idx) : rx_crc_good ? 0 : RAW_RX_BAD_CRC;
+
+                        if (status == 0 && pRawRxCbFunc != NULL)
+                        {
+                            (*pRawRxCbFunc)(rx_buf, rx_idx, raw_rx_hdl);
+                        }
+
+                        if (status == 0)
+                        {
+                            rx_good_count++;
+                            rx_last_tick = currTickCount;
+                        }
+                        else
+                        {
+                            trig       |= TRACE_TRIG_REJECT;
+                        }
+                    }
+
+                    trig               |= rx_crc_good ? 0 : TRACE_TRIG_BAD_CRC;
                 }
 
-                // Process input if no errors were seen
-                if (!error_detected)
+                // Open a dump window on a selected event
+                if (trig & trace_trig_mask)
                 {
-                    // Process input, subtracting the Premable and SFD
-                    processFrame(&rx_buf[pidx], rx_idx-pidx);
+                    UdpVpTraceEvent();
                 }
             }
             // Whilst receiving a frame, place it in the receive buffer
             else
             {
-                error_detected |= rxc & RX_ERROR_MASK;
-                if (rx_idx == (ETH_MTU + ETH_HDR_LEN + ETH_PREAMBLE + ETH_CRC_LEN + ETH_802_1Q_LEN))
+                rx_error_detected      |= (rxc & RX_ERROR_MASK) != 0;
+
+                // Strip the preamble and SFD (could be variable length) as they arrive
+                if (rx_in_preamble && (rxbyte == PREAMBLE || rxbyte == SFD))
                 {
-                    printf("WARNING: received packet of maximum size without completing frame. Terminating packet\n");
-                    receiving_frame = false;
-                    error_detected  = true;
+                    rx_in_preamble     = rxbyte != SFD;
+                }
+                else if (rx_idx == (ETH_MTU + ETH_HDR_LEN + ETH_PREAMBLE + ETH_CRC_LEN + ETH_802_1Q_LEN))
+                {
+                    UDP_LOG(node, UdpVpGetTicks(), udpLog::LOG_WARNING, "NODE%d: WARNING: received packet of maximum size without completing frame. Terminating packet\n", node);
+                    receiving_frame    = false;
+                    rx_error_detected  = true;
                 }
                 else
                 {
-                    rx_buf[rx_idx++] = rxbyte;
+                    rx_in_preamble     = false;
+                    UdpVpAccumRxByte(rxbyte);
+                    rx_buf[rx_idx++]   = rxbyte;
                 }
             }
         }
     }
 
+    // --------------------------------------------------
+    // Method to update the trace state at a scheduled
+    // window boundary, opening any windows that have
+    // started (merging overlapping ones) and closing
+    // the current one if ended.
+    // --------------------------------------------------
+    void UdpVpTraceUpdate()
+    {
+        uint32_t now                   = UdpVpGetTicks();
+
+        // Skip any windows that have already finished
+        while (trace_win_idx < trace_windows.size() && trace_windows[trace_win_idx].end <= now)
+        {
+            trace_win_idx++;
+        }
+
+        // Open started windows, extending the current one if already on
+        while (trace_win_idx < trace_windows.size() && trace_windows[trace_win_idx].start <= now)
+        {
+            trace_end                  = (trace_on && trace_end > trace_windows[trace_win_idx].end) ? trace_end : trace_windows[trace_win_idx].end;
+            UdpVpSetTrace(true);
+            trace_win_idx++;
+
+            // Absorb any later windows starting within this one
+            while (trace_win_idx < trace_windows.size() && trace_windows[trace_win_idx].start <= trace_end)
+            {
+                trace_end              = std::max(trace_end, trace_windows[trace_win_idx].end);
+                trace_win_idx++;
+            }
+        }
+
+        if (trace_on && now >= trace_end)
+        {
+            UdpVpSetTrace(false);
+        }
+
+        // Discard the used windows once all are done
+        if (trace_win_idx == trace_windows.size())
+        {
+            trace_windows.clear();
+            trace_win_idx              = 0;
+        }
+
+        // Next tick at which anything changes
+        trace_next_tick                = trace_on                       ? trace_end :
+                                         trace_win_idx < trace_windows.size() ? trace_windows[trace_win_idx].start :
+                                                                          TRACE_NO_TICK;
+    }
+
     // -------------------------------------------------
     // Private member variables
     // -------------------------------------------------
@@ -236,10 +1224,102 @@ private:
     // State flag to indicate actively receiving data
     bool           receiving_frame;
 
-    // Receive buffer and index. Buffer size is the maximum for largest payload, plus headers
+    // State flags for an error seen on the current frame, and still within its preamble
+    bool           rx_error_detected;
+    bool           rx_in_preamble;
+
+    // Optional TX fault injection engine
+    udpFaultInject* pFault;
+
+    // Optional raw received frame callback, and its handle
+    pRawRxCbFunc_t pRawRxCbFunc;
+    void*          raw_rx_hdl;
+
+    // Running receive integrity state for the current frame
+    const uint32_t* crc_table;
+    uint32_t       rx_crc;
+    uint32_t       rx_ipv4_sum;
+    uint32_t       rx_udp_sum_int;
+    uint32_t       rx_ipv4_hdr_end;
+    uint32_t       rx_ipv4_end;
+
+    // Count of frames accepted by processFrame(), and the tick the last one completed
+    uint32_t       rx_good_count;
+    uint32_t       rx_last_tick;
+
+    // Receive buffer and index (excluding preamble and SFD). Buffer size is the maximum for
+    // largest payload, plus headers
     uint32_t       rx_buf[ETH_MTU + ETH_HDR_LEN + ETH_PREAMBLE + ETH_CRC_LEN + ETH_802_1Q_LEN];
     uint32_t       rx_idx;
 
+    // Waveform dump window state: pending windows (sorted by start), the end of the
+    // current window, the next tick at which the state changes, and trigger settings
+    typedef struct {
+        uint32_t   start;
+        uint32_t   end;
+    } traceWindow_t;
+
+    std::vector<traceWindow_t> trace_windows;
+    uint32_t       trace_win_idx;
+    bool           trace_on;
+    uint32_t       trace_end;
+    uint32_t       trace_next_tick;
+    uint32_t       trace_trig_mask;
+    uint32_t       trace_pre;
+    uint32_t       trace_post;
+    FILE*          trace_trig_fp;
+
+    // Number of byte lanes per HDL access (0 until read from the HDL), and the
+    // partially built wide mode TX word
+    uint32_t       lanes;
+    uint32_t       tx_lane_idx;
+    uint32_t       tx_lane_lo;
+    uint32_t       tx_lane_hi;
+    uint32_t       tx_lane_ctl;
+
+    // Priority of TX frames for PFC, the ticks until which TX is paused (by PAUSE, and
+    // for each PFC priority), the pauses that may be in force (bit 0 PAUSE, bits 1 to 8
+    // PFC priorities), and MAC control counts
+    uint32_t       tx_priority;
+    uint32_t       pause_until;
+    uint32_t       pfc_until[PFC_PRIORITIES];
+    uint32_t       pause_active;
+    pauseStats_t   pause_stats;
+
+    // Transport to the HDL
+    transport_t    vp;
+
+    // TX descriptor ring: posted (head) and completed (tail) counts, the frame being
+    // sent (after any faults were applied), its length and next byte, the end tick
+    // of the last frame and the gap required after it, and the completion callback
+    typedef struct {
+        uint32_t*  frame;
+        uint32_t   len;
+        void*      tag;
+        uint32_t   start_tick;
+    } txDesc_t;
+
+    txDesc_t       tx_ring[TX_RING_SIZE];
+    uint32_t       tx_ring_head;
+    uint32_t       tx_ring_tail;
+    bool           tx_ring_busy;
+    bool           tx_ring_held;
+    uint32_t*      tx_ring_frame;
+    uint32_t       tx_ring_len;
+    uint32_t       tx_ring_idx;
+    uint32_t       tx_ring_end;
+    uint32_t       tx_ring_ifg;
+    pTxDoneCbFunc_t pTxDoneCbFunc;
+    void*          tx_done_hdl;
+
 };
 
+// Transport used by the node code, selected at build time (e.g. with
+// -DUDP_VP_TRANSPORT=udpVpLoopbackTransport)
+#ifndef UDP_VP_TRANSPORT
+#define UDP_VP_TRANSPORT udpVpVProcTransport
+#endif
+
+typedef udpVProcT<UDP_VP_TRANSPORT> udpVProc;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,541 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class method definitions for recording and replay of a
+// node's VProc transactions
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <stdlib.h>
+#include <string.h>
+#include <cinttypes>
+#include <mutex>
+
+extern "C" {
+#include "VUser.h"
+}
+
+#include "udpVpRecord.h"
+
+// Recording file identifier
+static const char     REC_MAGIC[8]     = {'U', 'D', 'P', 'V', 'R', 'E', 'C', '1'};
+
+// Header byte fields. A repeat record has the period (less 1) in the bits below
+// REC_REPEAT, followed by the run length. Otherwise the byte is a transaction's op,
+// with REC_DATA set if a data difference follows. A completed recording ends with
+// REC_END.
+static const uint8_t  REC_REPEAT       = 0x80;
+static const uint8_t  REC_DATA         = 0x40;
+static const uint8_t  REC_END          = 0xff;
+
+std::atomic<uint32_t> udpVpRecord::replays_finished(0);
+std::atomic<uint32_t> udpVpRecord::replays_diverged(0);
+
+// Open recordings, to be completed at exit
+static std::mutex                rec_lock;
+static std::vector<udpVpRecord*> open_recs;
+static bool                      at_exit_set   = false;
+
+// --------------------------------------------------
+// Constructor
+// --------------------------------------------------
+
+udpVpRecord::udpVpRecord () : buf(BUF_BYTES)
+{
+    mode                               = MODE_OFF;
+    node                               = 0;
+    fp                                 = NULL;
+    buf_idx                            = 0;
+    buf_len                            = 0;
+    hist_count                         = 0;
+    run_period                         = 0;
+    run_len                            = 0;
+    count                              = 0;
+    bytes                              = 0;
+    corrupt                            = false;
+    complete                           = false;
+}
+
+// --------------------------------------------------
+// Destructor
+// --------------------------------------------------
+
+udpVpRecord::~udpVpRecord ()
+{
+    close();
+}
+
+// --------------------------------------------------
+// Open a recording
+// --------------------------------------------------
+
+bool udpVpRecord::open (const char* fname, uint32_t modeIn, int nodeIn)
+{
+    close();
+
+    if (modeIn != MODE_RECORD && modeIn != MODE_REPLAY)
+    {
+        printf("udpVpRecord::open() : ***ERROR. Invalid mode (%d)\n", modeIn);
+        return false;
+    }
+
+    if ((fp = fopen(fname, modeIn == MODE_RECORD ? "wb" : "rb")) == NULL)
+    {
+        printf("udpVpRecord::open() : ***ERROR. Unable to open %s\n", fname);
+        return false;
+    }
+
+    node                               = nodeIn;
+    buf_idx                            = 0;
+    buf_len                            = 0;
+    hist_count                         = 0;
+    run_period                         = 0;
+    run_len                            = 0;
+    count                              = 0;
+    bytes                              = 0;
+    corrupt                            = false;
+    complete                           = false;
+
+    memset(prev, 0, sizeof(prev));
+
+    if (modeIn == MODE_RECORD)
+    {
+        for (uint32_t idx = 0; idx < sizeof(REC_MAGIC); idx++)
+        {
+            putByte(REC_MAGIC[idx]);
+        }
+        putByte(node);
+
+        std::lock_guard<std::mutex> guard(rec_lock);
+
+        open_recs.push_back(this);
+
+        if (!at_exit_set)
+        {
+            atexit(closeAll);
+            at_exit_set                = true;
+        }
+    }
+    else
+    {
+        uint8_t hdr[sizeof(REC_MAGIC) + 1];
+
+        if (fread(hdr, 1, sizeof(hdr), fp) != sizeof(hdr) || memcmp(hdr, REC_MAGIC, sizeof(REC_MAGIC)))
+        {
+            printf("udpVpRecord::open() : ***ERROR. %s is not a VProc recording\n", fname);
+            fclose(fp);
+            fp                         = NULL;
+            return false;
+        }
+
+        if (hdr[sizeof(REC_MAGIC)] != (uint8_t)node)
+        {
+            VPrint("NODE%d: replaying a recording of node %d\n", node, hdr[sizeof(REC_MAGIC)]);
+        }
+    }
+
+    mode                               = modeIn;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Complete a recording, or end a replay
+// --------------------------------------------------
+
+void udpVpRecord::close (void)
+{
+    if (fp == NULL)
+    {
+        return;
+    }
+
+    if (mode == MODE_RECORD)
+    {
+        flushRun();
+        putByte(REC_END);
+        flushBuf();
+
+        VPrint("NODE%d: recorded %" PRIu64 " VProc transactions in %" PRIu64 " bytes\n", node, count, bytes);
+
+        std::lock_guard<std::mutex> guard(rec_lock);
+
+        for (uint32_t idx = 0; idx < open_recs.size(); idx++)
+        {
+            if (open_recs[idx] == this)
+            {
+                open_recs.erase(open_recs.begin() + idx);
+                break;
+            }
+        }
+    }
+
+    fclose(fp);
+
+    fp                                 = NULL;
+    mode                               = MODE_OFF;
+}
+
+// --------------------------------------------------
+// Complete all open recordings, at exit
+// --------------------------------------------------
+
+void udpVpRecord::closeAll (void)
+{
+    std::vector<udpVpRecord*> recs;
+
+    {
+        std::lock_guard<std::mutex> guard(rec_lock);
+        recs.swap(open_recs);
+    }
+
+    for (uint32_t idx = 0; idx < recs.size(); idx++)
+    {
+        recs[idx]->close();
+    }
+}
+
+// --------------------------------------------------
+// Record a transaction. A transaction matching one
+// up to MAX_PERIOD before starts (or extends) a
+// repeat run, which is held back until it ends.
+// --------------------------------------------------
+
+void udpVpRecord::record (uint32_t op, uint32_t data)
+{
+    trans_t t                          = {op, data};
+
+    count++;
+
+    if (run_period)
+    {
+        if (same(t, histAt(run_period)))
+        {
+            run_len++;
+            push(t);
+            return;
+        }
+
+        flushRun();
+    }
+
+    uint32_t max_period                = (hist_count < MAX_PERIOD) ? (uint32_t)hist_count : MAX_PERIOD;
+
+    for (uint32_t period = 1; period <= max_period; period++)
+    {
+        if (same(t, histAt(period)))
+        {
+            run_period                 = period;
+            run_len                    = 1;
+            push(t);
+            return;
+        }
+    }
+
+    literal(t);
+    push(t);
+}
+
+// --------------------------------------------------
+// Output a transaction as a header byte, and any
+// data difference, zigzag encoded
+// --------------------------------------------------
+
+void udpVpRecord::literal (const trans_t &t)
+{
+    uint32_t diff                      = t.data - prev[t.op];
+
+    if (diff == 0)
+    {
+        putByte(t.op);
+    }
+    else
+    {
+        putByte(t.op | REC_DATA);
+        putVarint((diff << 1) ^ (uint32_t)((int32_t)diff >> 31));
+    }
+
+    prev[t.op]                         = t.data;
+}
+
+// --------------------------------------------------
+// Output the repeat run held back, as a repeat
+// record, or, if too short, as literals. The run's
+// transactions are the last run_len in the history.
+// --------------------------------------------------
+
+void udpVpRecord::flushRun (void)
+{
+    if (run_period == 0)
+    {
+        return;
+    }
+
+    if (run_len >= MIN_REPEAT)
+    {
+        putByte(REC_REPEAT | (run_period - 1));
+        putVarint(run_len);
+
+        // The last period of the run has the latest data of every op in it
+        uint32_t last                  = (run_len < run_period) ? (uint32_t)run_len : run_period;
+
+        for (uint32_t idx = last; idx > 0; idx--)
+        {
+            prev[histAt(idx).op]       = histAt(idx).data;
+        }
+    }
+    else
+    {
+        for (uint32_t idx = (uint32_t)run_len; idx > 0; idx--)
+        {
+            literal(histAt(idx));
+        }
+    }
+
+    run_period                         = 0;
+    run_len                            = 0;
+}
+
+// --------------------------------------------------
+// Buffered output
+// --------------------------------------------------
+
+void udpVpRecord::putByte (uint8_t byte)
+{
+    buf[buf_idx++]                     = byte;
+    bytes++;
+
+    if (buf_idx == BUF_BYTES)
+    {
+        flushBuf();
+    }
+}
+
+void udpVpRecord::putVarint (uint64_t val)
+{
+    while (val >= 0x80)
+    {
+        putByte((val & 0x7f) | 0x80);
+        val                            >>= 7;
+    }
+
+    putByte(val);
+}
+
+void udpVpRecord::flushBuf (void)
+{
+    if (buf_idx && fwrite(buf.data(), 1, buf_idx, fp) != buf_idx)
+    {
+        printf("udpVpRecord::flushBuf() : ***ERROR. Write of node %d recording failed\n", node);
+    }
+
+    buf_idx                            = 0;
+}
+
+// --------------------------------------------------
+// Decode the next recorded transaction. Returns
+// false at the end of the recording.
+// --------------------------------------------------
+
+bool udpVpRecord::next (trans_t &t)
+{
+    uint8_t  hdr;
+    uint64_t val;
+
+    while (run_len == 0)
+    {
+        if (!getByte(hdr))
+        {
+            return false;
+        }
+
+        if (hdr == REC_END)
+        {
+            complete                   = true;
+            return false;
+        }
+
+        if (!(hdr & REC_REPEAT))
+        {
+            t.op                       = hdr & ~REC_DATA;
+            t.data                     = prev[t.op];
+
+            if (hdr & REC_DATA)
+            {
+                if (!getVarint(val))
+                {
+                    corrupt            = true;
+                    return false;
+                }
+
+                t.data                 += ((uint32_t)val >> 1) ^ (0 - ((uint32_t)val & 1));
+            }
+
+            prev[t.op]                 = t.data;
+            push(t);
+            count++;
+
+            return true;
+        }
+
+        run_period                     = (hdr & ~REC_REPEAT) + 1;
+
+        if (!getVarint(run_len) || run_len == 0 || run_period > MAX_PERIOD || run_period > hist_count)
+        {
+            corrupt                    = true;
+            return false;
+        }
+    }
+
+    t                                  = histAt(run_period);
+    prev[t.op]                         = t.data;
+    push(t);
+    run_len--;
+    count++;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Buffered input
+// --------------------------------------------------
+
+bool udpVpRecord::getByte (uint8_t &byte)
+{
+    if (buf_idx == buf_len)
+    {
+        buf_idx                        = 0;
+        buf_len                        = fread(buf.data(), 1, BUF_BYTES, fp);
+
+        if (buf_len == 0)
+        {
+            return false;
+        }
+    }
+
+    byte                               = buf[buf_idx++];
+
+    return true;
+}
+
+bool udpVpRecord::getVarint (uint64_t &val)
+{
+    uint8_t byte;
+
+    val                                = 0;
+
+    for (uint32_t shift = 0; shift < 64; shift += 7)
+    {
+        if (!getByte(byte))
+        {
+            return false;
+        }
+
+        val                            |= (uint64_t)(byte & 0x7f) << shift;
+
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// --------------------------------------------------
+// Replay a write, checking it against the recording
+// --------------------------------------------------
+
+bool udpVpRecord::replayWrite (uint32_t addr, uint32_t data, bool delta)
+{
+    trans_t t;
+    trans_t w                          = {encOp(false, addr, delta), data};
+
+    if (!next(t))
+    {
+        replayEnd(NULL, w);
+        return false;
+    }
+
+    if (!same(t, w))
+    {
+        replayEnd(&t, w);
+        return false;
+    }
+
+    return true;
+}
+
+// --------------------------------------------------
+// Replay a read, returning the recorded value
+// --------------------------------------------------
+
+bool udpVpRecord::replayRead (uint32_t addr, uint32_t* data, bool delta)
+{
+    trans_t t;
+    trans_t r                          = {encOp(true, addr, delta), 0};
+
+    if (!next(t))
+    {
+        replayEnd(NULL, r);
+        return false;
+    }
+
+    if (t.op != r.op)
+    {
+        replayEnd(&t, r);
+        return false;
+    }
+
+    *data                              = t.data;
+
+    return true;
+}
+
+// --------------------------------------------------
+// Report the end of a replay: at the end of the
+// recording (rec is NULL), or on an access (acc)
+// differing from the recording (rec)
+// --------------------------------------------------
+
+void udpVpRecord::replayEnd (const trans_t* rec, const trans_t &acc)
+{
+    if (rec != NULL)
+    {
+        printf("udpVpRecord::replayEnd() : ***ERROR. Node %d differs from its recording at transaction %" PRIu64
+               ": recorded %s register %d (data 0x%08x, delta %d), replayed %s register %d (data 0x%08x, delta %d)\n",
+               node, count, (rec->op & OP_READ) ? "read of" : "write to", rec->op & (MAX_ADDR-1), rec->data, (rec->op & OP_DELTA) ? 1 : 0,
+               (acc.op & OP_READ) ? "read of" : "write to", acc.op & (MAX_ADDR-1), acc.data, (acc.op & OP_DELTA) ? 1 : 0);
+        replays_diverged++;
+    }
+    else if (corrupt)
+    {
+        printf("udpVpRecord::replayEnd() : ***ERROR. Node %d recording is corrupt after transaction %" PRIu64 "\n", node, count);
+        replays_diverged++;
+    }
+    else
+    {
+        VPrint("NODE%d: replay complete after %" PRIu64 " VProc transactions%s\n", node, count,
+               complete ? "" : " (recording incomplete)");
+    }
+
+    replays_finished++;
+
+    close();
+}
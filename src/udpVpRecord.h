@@ -0,0 +1,203 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Class header for recording and replay of a node's VProc
+// transactions
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_VP_RECORD_H_
+#define _UDP_VP_RECORD_H_
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+
+// -------------------------------------------------------------
+// Record and replay of a node's VProc transactions. When
+// recording, every write, and every read with the value
+// returned, is appended to a compressed binary stream. When
+// replaying, the node's writes are checked against the
+// recording, and its reads are given the recorded values, so
+// that the C++ side of a simulation can be rerun natively,
+// without the HDL (see tools/udpReplay.cpp). A replay ends at
+// the end of the recording, or when a write (or the address of
+// a read) differs from the recording.
+//
+// The stream is compressed for the access patterns of the
+// node: each transaction is a header byte, with the data, if
+// it differs from the last for the same register and access
+// type, as a variable length signed difference. A run of
+// transactions repeating the ones up to MAX_PERIOD before is
+// replaced by a single repeat record, so that idle periods,
+// and the lanes of a frame in flight, take a few bytes.
+//
+// Recordings still open when the program exits are completed
+// then, as a simulation may end without returning to the
+// nodes. A recording cut short (e.g. by the simulation being
+// killed) replays up to where it was cut, and is reported as
+// incomplete.
+// -------------------------------------------------------------
+
+class udpVpRecord
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    // Modes
+    static const uint32_t MODE_OFF             = 0;
+    static const uint32_t MODE_RECORD          = 1;
+    static const uint32_t MODE_REPLAY          = 2;
+
+    // Encodable register addresses
+    static const uint32_t MAX_ADDR             = 16;
+
+    // Longest repeating sequence of transactions (power of 2), and the shortest
+    // run worth a repeat record
+    static const uint32_t MAX_PERIOD           = 16;
+    static const uint32_t MIN_REPEAT           = 4;
+
+    // File buffer size
+    static const uint32_t BUF_BYTES            = 65536;
+
+    // Transaction op flags, above the register address
+    static const uint32_t OP_DELTA             = 0x10;
+    static const uint32_t OP_READ              = 0x20;
+
+    // --------------------------------------------
+    // Constructor/destructor
+    // --------------------------------------------
+
+    udpVpRecord ();
+    ~udpVpRecord ();
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Method to open a recording for a node, to record to or replay from. Returns
+    // false on error.
+    bool           open                (const char* fname, uint32_t modeIn, int nodeIn);
+
+    // Method to complete a recording, or end a replay
+    void           close               (void);
+
+    // Mode access
+    bool           recording           (void) {return mode == MODE_RECORD;};
+    bool           replaying           (void) {return mode == MODE_REPLAY;};
+
+    // Methods to record a write, or a read and the value it returned
+    void           recordWrite         (uint32_t addr, uint32_t data, bool delta) {record(encOp(false, addr, delta), data);};
+    void           recordRead          (uint32_t addr, uint32_t data, bool delta) {record(encOp(true,  addr, delta), data);};
+
+    // Methods to replay a write, or a read, returning the recorded value in data.
+    // Return false at the end of the recording, or if the access differs from it.
+    bool           replayWrite         (uint32_t addr, uint32_t data, bool delta);
+    bool           replayRead          (uint32_t addr, uint32_t* data, bool delta);
+
+    // Transactions recorded or replayed so far
+    uint64_t       getCount            (void) {return count;};
+
+    // Replays finished by all nodes, and those that differed from their recordings
+    static uint32_t replaysFinished    (void) {return replays_finished;};
+    static uint32_t replaysDiverged    (void) {return replays_diverged;};
+
+private:
+
+    // --------------------------------------------
+    // Private types
+    // --------------------------------------------
+
+    // A transaction. The op is the register address, with the OP_xxx flags.
+    typedef struct {
+        uint32_t       op;
+        uint32_t       data;
+    } trans_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    static uint32_t encOp              (bool read, uint32_t addr, bool delta)
+                                       {return (read ? OP_READ : 0) | (delta ? OP_DELTA : 0) | (addr & (MAX_ADDR-1));};
+
+    // Encoding
+    void           record              (uint32_t op, uint32_t data);
+    void           literal             (const trans_t &t);
+    void           flushRun            (void);
+    void           putByte             (uint8_t byte);
+    void           putVarint           (uint64_t val);
+    void           flushBuf            (void);
+
+    // Decoding
+    bool           next                (trans_t &t);
+    bool           getByte             (uint8_t &byte);
+    bool           getVarint           (uint64_t &val);
+
+    // Method to report the end of a replay
+    void           replayEnd           (const trans_t* rec, const trans_t &acc);
+
+    // History of transactions, for repeats
+    void           push                (const trans_t &t) {hist[hist_count++ & (MAX_PERIOD-1)] = t;};
+    trans_t&       histAt              (uint32_t period)  {return hist[(hist_count - period) & (MAX_PERIOD-1)];};
+    bool           same                (const trans_t &a, const trans_t &b) {return a.op == b.op && a.data == b.data;};
+
+    // Method to complete all open recordings, at exit
+    static void    closeAll            (void);
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    uint32_t       mode;
+    int            node;
+    FILE*          fp;
+
+    // File buffer, and the read position and fill when replaying
+    std::vector<uint8_t> buf;
+    uint32_t       buf_idx;
+    uint32_t       buf_len;
+
+    // Last data for each op, and the transaction history
+    uint32_t       prev[OP_READ << 1];
+    trans_t        hist[MAX_PERIOD];
+    uint64_t       hist_count;
+
+    // Repeat run being recorded or replayed: its period, and the transactions in it
+    // so far (recording), or left (replaying)
+    uint32_t       run_period;
+    uint64_t       run_len;
+
+    // Transactions, and bytes written, and whether a replayed recording was corrupt,
+    // or was read to its end marker
+    uint64_t       count;
+    uint64_t       bytes;
+    bool           corrupt;
+    bool           complete;
+
+    // Replay completion counts, over all nodes
+    static std::atomic<uint32_t> replays_finished;
+    static std::atomic<uint32_t> replays_diverged;
+};
+
+#endif
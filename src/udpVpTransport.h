@@ -0,0 +1,434 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Transport policies for udpVProc: the means by which a node
+// accesses the udpClient HDL's registers
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_VP_TRANSPORT_H_
+#define _UDP_VP_TRANSPORT_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+extern "C" {
+#include "VUser.h"
+}
+
+#include "udpVpRecord.h"
+
+// -------------------------------------------------------------
+// A transport policy is the template parameter of udpVProcT,
+// and is constructed with the node number. It provides:
+//
+//   void write (uint32_t addr, uint32_t  data, bool delta);
+//   void read  (uint32_t addr, uint32_t* data, bool delta);
+//   void tick  (uint32_t ticks);
+//
+// with the semantics of VWrite(), VRead() and VTick(): an
+// access with delta false advances the clock. The methods are
+// called directly (not virtually), so inline into the node's
+// per-byte send and receive loops. The transport is chosen at
+// build time with UDP_VP_TRANSPORT (see udpVProc.h).
+// -------------------------------------------------------------
+
+// -------------------------------------------------------------
+// udpClient HDL register map, common to the node and to the
+// transports that model the HDL
+// -------------------------------------------------------------
+
+class udpVpRegs
+{
+public:
+
+    // udpClient VProc address offsets
+    static const uint32_t TXD_ADDR             = 0;
+    static const uint32_t TXC_ADDR             = 1;
+    static const uint32_t TICKS_ADDR           = 2;
+    static const uint32_t HALT_ADDR            = 3;
+    static const uint32_t TRACE_ADDR           = 4;
+    static const uint32_t LANES_ADDR           = 5;
+    static const uint32_t WTXD_ADDR            = 6;
+    static const uint32_t WTXC_ADDR            = 7;
+    static const uint32_t WTXD_HI_ADDR         = 8;  // Lanes 4 to 7, for 8 lane (e.g. 64 bit XGMII) models
+
+    // TX and RX control bits
+    static const uint32_t RX_VALID_MASK        = 0x01;
+    static const uint32_t RX_ERROR_MASK        = 0x02;
+    static const uint32_t TX_CTRL_IDLE         = 0x00;
+    static const uint32_t TX_CTRL_VALID        = 0x01;
+    static const uint32_t TX_CTRL_ERROR        = 0x03;
+};
+
+// -------------------------------------------------------------
+// VProc transport: the HDL simulation, through the VProc API.
+// The default.
+// -------------------------------------------------------------
+
+class udpVpVProcTransport
+{
+public:
+
+    udpVpVProcTransport (int nodeIn) : node(nodeIn) {};
+
+    void           write               (uint32_t addr, uint32_t  data, bool delta) {VWrite(addr, data, delta, node);};
+    void           read                (uint32_t addr, uint32_t* data, bool delta) {VRead (addr, data, delta, node);};
+    void           tick                (uint32_t ticks)                            {VTick (ticks, node);};
+
+private:
+
+    int            node;
+};
+
+// -------------------------------------------------------------
+// Loopback transport: a C++ model of the HDL with the node's
+// TX connected to its own RX, for running, and timing, the
+// node code without a simulator. The number of byte lanes
+// (1 to 8) is taken from the UDP_LOOPBACK_LANES environment
+// variable, defaulting to 1. Halt and trace controls are
+// ignored.
+// -------------------------------------------------------------
+
+class udpVpLoopbackTransport : public udpVpRegs
+{
+public:
+
+    static const uint32_t MAX_LANES            = 8;
+
+    udpVpLoopbackTransport (int nodeIn)
+    {
+        const char* env                = getenv("UDP_LOOPBACK_LANES");
+
+        lanes                          = env ? strtoul(env, NULL, 0) : 1;
+        ticks                          = 0;
+
+        if (lanes < 1 || lanes > MAX_LANES)
+        {
+            printf("udpVpLoopbackTransport : ***ERROR. Invalid number of lanes (%s) for node %d, using 1\n", env, nodeIn);
+            lanes                      = 1;
+        }
+
+        for (uint32_t idx = 0; idx <= WTXD_HI_ADDR; idx++)
+        {
+            regs[idx]                  = 0;
+        }
+    };
+
+    void write (uint32_t addr, uint32_t data, bool delta)
+    {
+        if (addr <= WTXD_HI_ADDR)
+        {
+            regs[addr]                 = data;
+        }
+
+        ticks                          += delta ? 0 : lanes;
+    };
+
+    // TX data and control read back as RX, so that TXC's error bit
+    // (TX_CTRL_ERROR) is received as the RX error bit
+    void read (uint32_t addr, uint32_t* data, bool delta)
+    {
+        *data                          = (addr == TICKS_ADDR) ? ticks :
+                                         (addr == LANES_ADDR) ? lanes :
+                                         (addr == TXC_ADDR)   ? regs[addr] & (RX_VALID_MASK | RX_ERROR_MASK) :
+                                         (addr <= WTXD_HI_ADDR && addr != HALT_ADDR && addr != TRACE_ADDR) ? regs[addr] : 0;
+
+        ticks                          += delta ? 0 : lanes;
+    };
+
+    void           tick                (uint32_t ticksIn) {ticks += ticksIn;};
+
+private:
+
+    uint32_t       lanes;
+    uint32_t       ticks;
+    uint32_t       regs[WTXD_HI_ADDR+1];
+};
+
+// -------------------------------------------------------------
+// Recording transport: another transport (by default VProc)
+// with the node's writes, and its reads with the values
+// returned, recorded (see udpVpRecord). Recording starts at
+// construction if the UDP_RECORD environment variable gives
+// a file name prefix, to <prefix><node>.vprec, or with
+// record(). udpVpRecordTransport records a VProc simulation.
+// -------------------------------------------------------------
+
+template <class transport_t> class udpVpRecorder
+{
+public:
+
+    udpVpRecorder (int nodeIn) : vp(nodeIn), node(nodeIn)
+    {
+        const char* prefix             = getenv("UDP_RECORD");
+        char        fname[256];
+
+        if (prefix != NULL)
+        {
+            snprintf(fname, sizeof(fname), "%s%d.vprec", prefix, node);
+            record(fname);
+        }
+    };
+
+    // Recorded first, as the simulation may end on the write
+    void write (uint32_t addr, uint32_t data, bool delta)
+    {
+        if (rec.recording())
+        {
+            rec.recordWrite(addr, data, delta);
+        }
+
+        vp.write(addr, data, delta);
+    };
+
+    void read (uint32_t addr, uint32_t* data, bool delta)
+    {
+        vp.read(addr, data, delta);
+
+        if (rec.recording())
+        {
+            rec.recordRead(addr, *data, delta);
+        }
+    };
+
+    void           tick                (uint32_t ticks) {vp.tick(ticks);};
+
+    // Method to start recording to a file, before the node's first access. Returns
+    // false on error.
+    bool           record              (const char* fname) {return rec.open(fname, udpVpRecord::MODE_RECORD, node);};
+
+private:
+
+    transport_t    vp;
+    int            node;
+    udpVpRecord    rec;
+};
+
+typedef udpVpRecorder<udpVpVProcTransport> udpVpRecordTransport;
+
+// -------------------------------------------------------------
+// Replay transport: no HDL, for nodes built natively to replay
+// their recorded transactions (see udpVpRecord and
+// tools/udpReplay.cpp). The node's writes are checked against
+// the recording, and its reads are given the recorded values.
+// The recording is opened at construction if the UDP_REPLAY
+// environment variable gives a file name prefix, from
+// <prefix><node>.vprec, or with replay(). At the end of the
+// replay, or when the node differs from the recording, the
+// node waits forever, as at the end of a simulation. A node
+// accessing the transport without a recording is counted, and
+// also waits.
+// -------------------------------------------------------------
+
+class udpVpReplayTransport
+{
+public:
+
+    udpVpReplayTransport (int nodeIn) : node(nodeIn)
+    {
+        const char* prefix             = getenv("UDP_REPLAY");
+        char        fname[256];
+
+        opened                         = false;
+
+        if (prefix != NULL)
+        {
+            snprintf(fname, sizeof(fname), "%s%d.vprec", prefix, node);
+            replay(fname);
+        }
+    };
+
+    void write (uint32_t addr, uint32_t data, bool delta)
+    {
+        if (!rec.replaying() || !rec.replayWrite(addr, data, delta))
+        {
+            end();
+        }
+    };
+
+    void read (uint32_t addr, uint32_t* data, bool delta)
+    {
+        if (!rec.replaying() || !rec.replayRead(addr, data, delta))
+        {
+            end();
+        }
+    };
+
+    void           tick                (uint32_t ticks) {park();};
+
+    // Method to open the recording to replay, before the node's first access.
+    // Returns false on error.
+    bool           replay              (const char* fname) {return opened = rec.open(fname, udpVpRecord::MODE_REPLAY, node);};
+
+    // Nodes that accessed the transport without a recording
+    static std::atomic<uint32_t>& noRecordingCount (void)
+    {
+        static std::atomic<uint32_t> count(0);
+        return count;
+    }
+
+    static void park (void)
+    {
+        while (true)
+        {
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+
+private:
+
+    // Method called when the replay cannot continue
+    void end (void)
+    {
+        if (!opened)
+        {
+            printf("udpVpReplayTransport : ***ERROR. Node %d accessed the HDL without a recording to replay\n", node);
+            noRecordingCount()++;
+        }
+
+        park();
+    }
+
+    int            node;
+    bool           opened;
+    udpVpRecord    rec;
+};
+
+// -------------------------------------------------------------
+// Pcap transport: a sink, with no HDL, writing the frames the
+// node sends to <prefix><node>.pcap, with the prefix from the
+// UDP_PCAP environment variable (default "node"). Frames are
+// written without preamble, SFD and FCS, timestamped (to the
+// ns) from the tick of their first byte, at TICK_NS per tick.
+// Nothing is received, and the node is a single lane.
+// -------------------------------------------------------------
+
+class udpVpPcapTransport : public udpVpRegs
+{
+public:
+
+    static const uint32_t TICK_NS              = 8;           // 1GbE byte time
+    static const uint32_t PCAP_MAGIC_NS        = 0xa1b23c4d;  // Nanosecond timestamps
+    static const uint32_t PCAP_LINKTYPE_ETH    = 1;
+    static const uint32_t PCAP_SNAPLEN         = 65535;
+    static const uint32_t FCS_LEN              = 4;
+
+    udpVpPcapTransport (int nodeIn)
+    {
+        const char* prefix             = getenv("UDP_PCAP");
+        char        fname[256];
+
+        snprintf(fname, sizeof(fname), "%s%d.pcap", prefix ? prefix : "node", nodeIn);
+
+        ticks                          = 0;
+        txd                            = 0;
+        in_frame                       = false;
+        frame_tick                     = 0;
+
+        // Global header: magic, version 2.4, timezone and accuracy, snap length and link type
+        uint32_t hdr[6]                = {PCAP_MAGIC_NS, 2 | (4 << 16), 0, 0, PCAP_SNAPLEN, PCAP_LINKTYPE_ETH};
+
+        if ((fp = fopen(fname, "wb")) == NULL || fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr))
+        {
+            printf("udpVpPcapTransport : ***ERROR. Unable to open %s for writing\n", fname);
+        }
+    };
+
+    ~udpVpPcapTransport ()
+    {
+        if (fp != NULL)
+        {
+            fclose(fp);
+        }
+    };
+
+    void write (uint32_t addr, uint32_t data, bool delta)
+    {
+        if (addr == TXD_ADDR)
+        {
+            txd                        = data & 0xff;
+        }
+        else if (addr == TXC_ADDR)
+        {
+            if (data & TX_CTRL_VALID)
+            {
+                frame_tick             = in_frame ? frame_tick : ticks;
+                in_frame               = true;
+                frame.push_back(txd);
+            }
+            else if (in_frame)
+            {
+                writeFrame();
+            }
+        }
+
+        ticks                          += delta ? 0 : 1;
+    };
+
+    void read (uint32_t addr, uint32_t* data, bool delta)
+    {
+        *data                          = (addr == TICKS_ADDR) ? ticks : (addr == LANES_ADDR) ? 1 : 0;
+
+        ticks                          += delta ? 0 : 1;
+    };
+
+    void           tick                (uint32_t ticksIn) {ticks += ticksIn;};
+
+private:
+
+    void writeFrame (void)
+    {
+        uint32_t start                 = 0;
+
+        // Strip the preamble and SFD
+        while (start < frame.size() && frame[start] == 0x55)
+        {
+            start++;
+        }
+        start                          += (start < frame.size() && frame[start] == 0xd5) ? 1 : 0;
+
+        uint32_t len                   = (frame.size() - start > FCS_LEN) ? frame.size() - start - FCS_LEN : 0;
+        uint64_t ns                    = (uint64_t)frame_tick * TICK_NS;
+        uint32_t rec[4]                = {(uint32_t)(ns / 1000000000ULL), (uint32_t)(ns % 1000000000ULL), len, len};
+
+        if (fp != NULL && len)
+        {
+            fwrite(rec, 1, sizeof(rec), fp);
+            fwrite(&frame[start], 1, len, fp);
+        }
+
+        frame.clear();
+        in_frame                       = false;
+    }
+
+    FILE*          fp;
+    uint32_t       ticks;
+    uint32_t       txd;
+    bool           in_frame;
+    uint32_t       frame_tick;
+    std::vector<uint8_t> frame;
+};
+
+#endif
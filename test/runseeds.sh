@@ -0,0 +1,163 @@
+#!/usr/bin/env bash
+###################################################################
+# Parallel multi-seed regression runner for the udp_ip_pg test
+# bench. Builds the simulation once, then runs a set of seeds
+# concurrently, each in its own working directory with a
+# +seed=<n> plusarg, and writes an aggregated report.
+#
+# Copyright (c) 2026 Simon Southwell.
+#
+# This file is part of udp_ip_pg.
+#
+# This file is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# The file is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this file. If not, see <http://www.gnu.org/licenses/>.
+#
+###################################################################
+#
+# Usage: runseeds.sh [options]
+#
+#   -n <num>   Number of seeds to run                 (default 100)
+#   -s <seed>  First seed                             (default 1)
+#   -j <jobs>  Number of concurrent runs              (default number of cores)
+#   -t <sim>   Simulator: verilator, verilator_perf or icarus
+#                                                     (default verilator_perf)
+#   -c <cmd>   Run command for other simulators, run in each seed's
+#              directory with {seed} replaced by the seed (skips the build)
+#   -o <dir>   Output directory                       (default regress)
+#
+# A run passes if it exits with zero status and its log has no
+# errors (***ERROR, non-zero payload byte errors, or WARNING lines).
+# The script exits with non-zero status if any run fails.
+#
+###################################################################
+
+NUMSEEDS=100
+FIRSTSEED=1
+JOBS=$(nproc 2>/dev/null || echo 4)
+SIM=verilator_perf
+RUNCMD=
+OUTDIR=regress
+
+while getopts "n:s:j:t:c:o:h" opt; do
+  case $opt in
+    n) NUMSEEDS=$OPTARG ;;
+    s) FIRSTSEED=$OPTARG ;;
+    j) JOBS=$OPTARG ;;
+    t) SIM=$OPTARG ;;
+    c) RUNCMD=$OPTARG ;;
+    o) OUTDIR=$OPTARG ;;
+    *) sed -n '/^# Usage/,/^####/p' "$0" | sed 's/^# \{0,1\}//;/^###/d'; exit 1 ;;
+  esac
+done
+
+TESTDIR=$(cd "$(dirname "$0")" && pwd)
+
+#------------------------------------------------------
+# Build once, and select the run command
+#------------------------------------------------------
+
+if [ -z "$RUNCMD" ]; then
+  case $SIM in
+    verilator)
+      make -C "$TESTDIR" -f makefile.verilator || exit 1
+      RUNCMD="$TESTDIR/work/Vtb +seed={seed}" ;;
+    verilator_perf)
+      # Single threaded, as the seeds already run in parallel across the cores, and
+      # Verilator's worker threads spin, so would oversubscribe them
+      make -C "$TESTDIR" -f makefile.verilator perf THREADS=1 || exit 1
+      RUNCMD="$TESTDIR/work_perf/Vtb +seed={seed}" ;;
+    icarus)
+      make -C "$TESTDIR" -f makefile.ica || exit 1
+      RUNCMD="vvp -n -m $TESTDIR/VProc.so $TESTDIR/sim +seed={seed}" ;;
+    *)
+      echo "$0: ***ERROR. Unknown simulator $SIM (use -c for other simulators)"; exit 1 ;;
+  esac
+fi
+
+mkdir -p "$OUTDIR" || exit 1
+OUTDIR=$(cd "$OUTDIR" && pwd)
+
+#------------------------------------------------------
+# Run a single seed in its own directory, writing a
+# one line result: seed status wall_ms warnings errors result
+#------------------------------------------------------
+
+run_seed()
+{
+  local seed=$1
+  local dir="$OUTDIR/seed_$seed"
+  local cmd=${RUNCMD//\{seed\}/$seed}
+
+  rm -rf "$dir" && mkdir -p "$dir"
+
+  local t0=$(date +%s%N)
+  (cd "$dir" && eval "$cmd") > "$dir/sim.log" 2>&1
+  local status=$?
+  local t1=$(date +%s%N)
+
+  local warnings=$(grep -c "WARNING" "$dir/sim.log")
+  local errors=$(grep -c -E "\*\*\*ERROR|with [1-9][0-9]* byte errors" "$dir/sim.log")
+  local result=PASS
+
+  if [ $status -ne 0 ] || [ "$errors" -ne 0 ] || [ "$warnings" -ne 0 ]; then
+    result=FAIL
+  fi
+
+  printf "%10s %6d %10d %8d %8d %s\n" "$seed" "$status" $(( (t1 - t0) / 1000000 )) "$warnings" "$errors" "$result" > "$dir/result"
+}
+
+export -f run_seed
+export OUTDIR RUNCMD
+
+#------------------------------------------------------
+# Run all the seeds, JOBS at a time
+#------------------------------------------------------
+
+T0=$(date +%s%N)
+
+seq "$FIRSTSEED" $(( FIRSTSEED + NUMSEEDS - 1 )) | xargs -P "$JOBS" -I{} bash -c 'run_seed {}'
+
+T1=$(date +%s%N)
+
+#------------------------------------------------------
+# Aggregate the results
+#------------------------------------------------------
+
+REPORT="$OUTDIR/report.txt"
+
+{
+  printf "udp_ip_pg seed regression: %d seeds from %d, %d jobs\n" "$NUMSEEDS" "$FIRSTSEED" "$JOBS"
+  printf "Run command: %s\n\n" "$RUNCMD"
+  printf "%10s %6s %10s %8s %8s %s\n" SEED STATUS WALL_MS WARNINGS ERRORS RESULT
+
+  PASSED=0
+  TOTALMS=0
+
+  for ((seed = FIRSTSEED; seed < FIRSTSEED + NUMSEEDS; seed++)); do
+    if [ -f "$OUTDIR/seed_$seed/result" ]; then
+      read -r _ _ ms _ _ result < "$OUTDIR/seed_$seed/result"
+      cat "$OUTDIR/seed_$seed/result"
+      TOTALMS=$(( TOTALMS + ms ))
+      [ "$result" = PASS ] && PASSED=$(( PASSED + 1 ))
+    else
+      printf "%10s %6s %10s %8s %8s %s\n" "$seed" - - - - FAIL
+    fi
+  done
+
+  printf "\n%d of %d passed\n" "$PASSED" "$NUMSEEDS"
+  printf "Elapsed %d ms, total run time %d ms\n" $(( (T1 - T0) / 1000000 )) "$TOTALMS"
+} > "$REPORT"
+
+cat "$REPORT"
+
+[ "$PASSED" -eq "$NUMSEEDS" ]
@@ -25,7 +25,7 @@
 #include <stdlib.h>
 
 #include "VUserMain.h"
-#include "udptest0.h"
+#include "udpTest0.h"
 
 // I'm node 0
 static int node = 0;
@@ -43,6 +43,9 @@ extern "C" void VUserMain0()
     VPrint(  "*    Copyright (c) 2025     *\n");
     VPrint(  "*****************************\n\n");
 
+    // Move log formatting and output off the simulation threads (for both nodes)
+    udpLog::instance().start();
+
     udpTest0* pTest = new udpTest0(0);
 
     pTest->runTest();
@@ -0,0 +1,421 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// C++20 coroutine based test scheduling for udpIpPg test
+// programs. Requires C++20 (as used for the Verilator build),
+// otherwise nothing is defined.
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _UDP_CORO_H_
+#define _UDP_CORO_H_
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <deque>
+#include <list>
+#include <map>
+
+#include "udpTestBase.h"
+
+// Coroutine scheduling is available
+#define UDP_CORO
+
+// -------------------------------------------------------------
+// Usage: write each concurrent activity as a coroutine returning
+// udpTask, taking the scheduler, and co_await on its methods:
+//
+//   udpTask pinger(udpScheduler& s)
+//   {
+//       uint32_t sent = co_await s.send(frm, len);
+//       auto     rx   = co_await s.recv(UDP_PORT_NUM, 1000);
+//       if (!rx.timed_out) VPrint("RTT = %d\n", rx.tick - sent);
+//   }
+//
+//   sched.spawn(pinger(sched));
+//   sched.run();
+//
+// The scheduler advances the node one tick at a time, driving
+// any queued frames byte by byte, so tasks are resumed on the
+// tick their event occurred. Deadlines are kept as 64 bit
+// ticks, extended from the node's 32 bit count, so they are
+// ordered correctly across its wrap. RFC 2544 test frames and
+// file transfer datagrams are passed on as by udpTestBase, and
+// not to the tasks.
+// -------------------------------------------------------------
+
+// -------------------------------------------------------------
+// Coroutine task type
+// -------------------------------------------------------------
+
+class udpTask
+{
+public:
+    struct promise_type
+    {
+        udpTask             get_return_object   () {return udpTask(std::coroutine_handle<promise_type>::from_promise(*this));};
+        std::suspend_always initial_suspend     () noexcept {return {};};
+        std::suspend_always final_suspend       () noexcept {return {};};
+        void                return_void         () {};
+        void                unhandled_exception () {std::terminate();};
+    };
+
+    explicit udpTask (std::coroutine_handle<promise_type> h) : handle(h) {};
+             udpTask (udpTask&& other) : handle(other.handle) {other.handle = nullptr;};
+            ~udpTask () {if (handle) handle.destroy();};
+
+    udpTask(const udpTask&)            = delete;
+    udpTask& operator=(const udpTask&) = delete;
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// -------------------------------------------------------------
+// Per node task scheduler
+// -------------------------------------------------------------
+
+class udpScheduler
+{
+public:
+
+    // --------------------------------------------
+    // Static constants
+    // --------------------------------------------
+
+    static const uint32_t ANY_PORT             = 0xffffffff;
+    static const uint32_t NO_TIMEOUT           = 0xffffffff;
+
+    // Idle ticks inserted after each frame, as for UdpVpSendRawEthFrame()
+    static const uint32_t TX_GAP_TICKS         = 1;
+
+    // --------------------------------------------
+    // Type definitions
+    // --------------------------------------------
+
+    // Result of a receive
+    typedef struct {
+        bool              timed_out;
+        uint32_t          tick;
+        udpIpPg::rxInfo_t pkt;
+    } rxResult_t;
+
+    // --------------------------------------------
+    // Constructor
+    // --------------------------------------------
+
+    udpScheduler (udpIpPg* pUdpIn) : pUdp(pUdpIn)
+    {
+        tx_idx                         = 0;
+        tx_gap                         = 0;
+        tx_no_ifg                      = false;
+        tx_active                      = false;
+        tick64                         = 0;
+        last_tick                      = now();
+
+        // The scheduler takes over delivery of received packets
+        pUdp->registerUsrRxCbFunc(rxCallback, (void*)this);
+    };
+
+    // --------------------------------------------
+    // Awaitables
+    // --------------------------------------------
+
+    // Wait for a number of ticks
+    struct delayAwaiter
+    {
+        udpScheduler* s;
+        uint32_t      ticks;
+
+        bool          await_ready   () {return ticks == 0;};
+        void          await_suspend (std::coroutine_handle<> h) {s->timers.emplace(s->now64() + ticks, h);};
+        void          await_resume  () {};
+    };
+
+    // Queue a frame for transmission and wait for its last byte to be sent,
+    // returning the tick at which it completed
+    struct sendAwaiter
+    {
+        udpScheduler* s;
+        uint32_t*     frame;
+        uint32_t      len;
+        uint32_t      done_tick;
+
+        bool          await_ready   () {return len == 0;};
+        void          await_suspend (std::coroutine_handle<> h) {s->txQueue.push_back({frame, len, h, &done_tick});};
+        uint32_t      await_resume  () {return done_tick;};
+    };
+
+    // Wait for a packet to the given port (or ANY_PORT), with a timeout in ticks (or NO_TIMEOUT)
+    struct recvAwaiter
+    {
+        udpScheduler* s;
+        uint32_t      port;
+        uint32_t      timeout;
+        rxResult_t    result;
+
+        bool          await_ready   () {return s->takePending(port, result);};
+        void          await_suspend (std::coroutine_handle<> h) {s->rxWaiters.push_back({port, s->now64() + timeout, timeout != NO_TIMEOUT, h, &result});};
+        rxResult_t    await_resume  () {return result;};
+    };
+
+    delayAwaiter   delay               (uint32_t ticks)                        {return {this, ticks};};
+    sendAwaiter    send                (uint32_t* frame, uint32_t len)         {return {this, frame, len, now()};};
+    recvAwaiter    recv                (uint32_t port = ANY_PORT, uint32_t timeout = NO_TIMEOUT)
+                                                                               {return {this, port, timeout, {}};};
+
+    // --------------------------------------------
+    // Public methods
+    // --------------------------------------------
+
+    // Add a task to be run
+    void           spawn               (udpTask&& task) {tasks.push_back(std::move(task)); ready.push_back(tasks.back().handle);};
+
+    // Current tick
+    uint32_t       now                 () {return pUdp->UdpVpGetTicks();};
+
+    // Current tick, extended to 64 bits from when the scheduler was created
+    uint64_t now64 ()
+    {
+        uint32_t tick                  = now();
+
+        tick64                         += (uint32_t)(tick - last_tick);
+        last_tick                      = tick;
+
+        return tick64;
+    }
+
+    // Run all the tasks until they have completed
+    void run()
+    {
+        while (true)
+        {
+            // Resume everything made ready on this tick
+            while (!ready.empty())
+            {
+                std::coroutine_handle<> h = ready.front();
+                ready.pop_front();
+                h.resume();
+            }
+
+            // Remove completed tasks
+            tasks.remove_if([](const udpTask& t) {return t.handle.done();});
+
+            if (tasks.empty())
+            {
+                break;
+            }
+
+            advanceTick();
+        }
+    }
+
+private:
+
+    // --------------------------------------------
+    // Private type definitions
+    // --------------------------------------------
+
+    typedef struct {
+        uint32_t*               frame;
+        uint32_t                len;
+        std::coroutine_handle<> h;
+        uint32_t*               done_tick;
+    } txEntry_t;
+
+    typedef struct {
+        uint32_t                port;
+        uint64_t                deadline;
+        bool                    has_deadline;
+        std::coroutine_handle<> h;
+        rxResult_t*             result;
+    } rxWaiter_t;
+
+    typedef struct {
+        uint32_t                tick;
+        udpIpPg::rxInfo_t       pkt;
+    } rxPending_t;
+
+    // --------------------------------------------
+    // Private methods
+    // --------------------------------------------
+
+    // Check for an expired deadline
+    bool expired(uint64_t deadline) {return deadline <= now64();};
+
+    // Advance the node by one tick, sending the next TX byte or idle, and
+    // waking any tasks whose events have occurred
+    void advanceTick()
+    {
+        if (!tx_active && tx_gap == 0 && !txQueue.empty())
+        {
+            bool no_ifg                = false;
+
+            tx_cur                     = txQueue.front();
+            txQueue.pop_front();
+
+            // Send posted frames, wait out any pause, and inject faults, as for
+            // UdpVpSendRawEthFrame()
+            tx_cur.frame               = pUdp->UdpVpTxPrepare(tx_cur.frame, tx_cur.len, no_ifg);
+            tx_idx                     = 0;
+            tx_no_ifg                  = no_ifg;
+            tx_active                  = true;
+        }
+
+        if (tx_active)
+        {
+            pUdp->UdpVpSendFrameByte(tx_cur.frame, tx_idx++, tx_cur.len);
+
+            if (tx_idx == tx_cur.len)
+            {
+                *tx_cur.done_tick      = now();
+                ready.push_back(tx_cur.h);
+                tx_active              = false;
+                tx_gap                 = tx_no_ifg ? 0 : TX_GAP_TICKS;
+            }
+        }
+        else
+        {
+            pUdp->UdpVpSendIdle(1);
+            tx_gap                     -= tx_gap ? 1 : 0;
+        }
+
+        // Wake expired delays
+        while (!timers.empty() && expired(timers.begin()->first))
+        {
+            ready.push_back(timers.begin()->second);
+            timers.erase(timers.begin());
+        }
+
+        // Wake timed out receivers
+        for (auto it = rxWaiters.begin(); it != rxWaiters.end();)
+        {
+            if (it->has_deadline && expired(it->deadline))
+            {
+                it->result->timed_out  = true;
+                it->result->tick       = now();
+                ready.push_back(it->h);
+                it                     = rxWaiters.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    // Take an already received packet for a port, if any
+    bool takePending(uint32_t port, rxResult_t &result)
+    {
+        for (auto it = rxPending.begin(); it != rxPending.end(); it++)
+        {
+            if (port == ANY_PORT || it->pkt.udp_dst_port == port)
+            {
+                result.timed_out       = false;
+                result.tick            = it->tick;
+                result.pkt             = it->pkt;
+                rxPending.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Received packet callback. Hands the packet to the first task waiting on its port,
+    // else holds it until one asks for it.
+    static void rxCallback(udpIpPg::rxInfo_t rx_info, void* hdl)
+    {
+        udpScheduler* s                = (udpScheduler*)hdl;
+
+        if (udpTestBase::divertRx(rx_info, s->pUdp))
+        {
+            return;
+        }
+
+        for (auto it = s->rxWaiters.begin(); it != s->rxWaiters.end(); it++)
+        {
+            if (it->port == ANY_PORT || it->port == rx_info.udp_dst_port)
+            {
+                it->result->timed_out  = false;
+                it->result->tick       = s->now();
+                it->result->pkt        = rx_info;
+                s->ready.push_back(it->h);
+                s->rxWaiters.erase(it);
+                return;
+            }
+        }
+
+        s->rxPending.push_back({s->now(), rx_info});
+    }
+
+    // --------------------------------------------
+    // Private member variables
+    // --------------------------------------------
+
+    // Node's packet generator
+    udpIpPg*                                       pUdp;
+
+    // Tasks, and those ready to be resumed
+    std::list<udpTask>                             tasks;
+    std::deque<std::coroutine_handle<>>            ready;
+
+    // Tasks waiting on a tick
+    std::multimap<uint64_t, std::coroutine_handle<>> timers;
+
+    // Extended tick count, and the node's tick count it was last updated from
+    uint64_t                                       tick64;
+    uint32_t                                       last_tick;
+
+    // Transmit queue and current frame state
+    std::deque<txEntry_t>                          txQueue;
+    txEntry_t                                      tx_cur;
+    uint32_t                                       tx_idx;
+    uint32_t                                       tx_gap;
+    bool                                           tx_no_ifg;
+    bool                                           tx_active;
+
+    // Tasks waiting on receive, and packets yet to be collected
+    std::list<rxWaiter_t>                          rxWaiters;
+    std::deque<rxPending_t>                        rxPending;
+};
+
+// -------------------------------------------------------------
+// Test base class with a coroutine scheduler for the node
+// -------------------------------------------------------------
+
+class udpCoroTestBase : public udpTestBase
+{
+public:
+
+                     udpCoroTestBase(int nodeIn) : udpTestBase(nodeIn), pSched(NULL) {};
+    virtual         ~udpCoroTestBase() {delete pSched;};
+
+protected:
+
+    // Create the scheduler, once pUdp has been constructed
+    udpScheduler*    createScheduler() {if (pSched == NULL && pUdp != NULL) pSched = new udpScheduler(pUdp); return pSched;};
+
+    // The node's task scheduler
+    udpScheduler*    pSched;
+};
+
+#endif
+
+#endif
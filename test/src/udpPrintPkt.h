@@ -27,6 +27,7 @@
 #define _UDP_PRINT_PKT_
 
 #include "udpIpPg.h"
+#include "udpLog.h"
 
 class udpPrintPkt
 {
@@ -34,9 +35,13 @@ public:
     // Constructor
     udpPrintPkt() {};
 
-    // Method to print out formatted receive data
-    void printRxPkt(udpIpPg::rxInfo_t &rx_info, int nodenum)
+    // Method to print out formatted receive data, received at the given tick
+    void printRxPkt(udpIpPg::rxInfo_t &rx_info, int nodenum, uint32_t tick = 0)
     {
+        if (!udpLog::instance().enabled(udpLog::LOG_INFO))
+        {
+            return;
+        }
 
 #ifdef NEWPREFIX
         sprintf(strbuf, "%s(%d)%s%s(%d)", (nodenum ? "client" : "server"),
@@ -48,30 +53,24 @@ public:
         sprintf(strbuf, "Node%d", nodenum);
 #endif
 
-        VPrint("%s: Source MAC Addr...........: ", strbuf);
-        for (int idx = 0; idx < 6; idx++)
-        {
-            VPrint("%02lX", (unsigned long)((rx_info.mac_src_addr >> 8*(5-idx)) & 0xff));
-            if (idx != 5)
-                VPrint("-");
-            else
-                VPrint("\n");
-        }
-
-        VPrint("%s: Source IPv4 Addr..........: ", strbuf);
-        for (int idx = 0; idx < 4; idx++)
-        {
-            VPrint("%02d", (rx_info.ipv4_src_addr >> 8*(3-idx)) & 0xff);
-            if (idx != 3)
-                VPrint(".");
-            else
-                VPrint("\n");
-        }
-
-        VPrint("%s: Source UDP port...........: 0x%04x\n", strbuf, rx_info.udp_src_port);
-        VPrint("%s: Destination UDP port......: 0x%04x\n", strbuf, rx_info.udp_dst_port);
-
-        VPrint("\n");
+        // Log as a single message, so the formatting is done off the simulation thread
+        udpLog::instance().log(nodenum, tick, udpLog::LOG_INFO,
+                               "%s: Source MAC Addr...........: %02X-%02X-%02X-%02X-%02X-%02X\n"
+                               "%s: Source IPv4 Addr..........: %02d.%02d.%02d.%02d\n"
+                               "%s: Source UDP port...........: 0x%04x\n"
+                               "%s: Destination UDP port......: 0x%04x\n\n",
+                               strbuf, (uint32_t)(rx_info.mac_src_addr >> 40) & 0xff,
+                                       (uint32_t)(rx_info.mac_src_addr >> 32) & 0xff,
+                                       (uint32_t)(rx_info.mac_src_addr >> 24) & 0xff,
+                                       (uint32_t)(rx_info.mac_src_addr >> 16) & 0xff,
+                                       (uint32_t)(rx_info.mac_src_addr >>  8) & 0xff,
+                                       (uint32_t)(rx_info.mac_src_addr      ) & 0xff,
+                               strbuf, (rx_info.ipv4_src_addr >> 24) & 0xff,
+                                       (rx_info.ipv4_src_addr >> 16) & 0xff,
+                                       (rx_info.ipv4_src_addr >>  8) & 0xff,
+                                       (rx_info.ipv4_src_addr      ) & 0xff,
+                               strbuf, rx_info.udp_src_port,
+                               strbuf, rx_info.udp_dst_port);
     }
 private:
 
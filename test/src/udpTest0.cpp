@@ -54,6 +54,67 @@ void udpTest0::sendTextMessage(const char* mess_str, const uint32_t dst_port, co
     pUdp->UdpVpSendRawEthFrame (frmBuf, len);
 }
 
+// --------------------------------------------
+// Helper method to send a UDP pattern message
+// --------------------------------------------
+void udpTest0::sendPatternMessage(const uint32_t pattern_len, const uint32_t dst_port, const uint32_t ip_dst_addr, const uint64_t mac_dst_addr, udpIpPg *pUdp)
+{
+    udpIpPg::udpConfig_t pktCfg;
+
+    // Fill payload buffer with header and next section of the pattern, and record on the scoreboard
+    uint32_t payloadlen = payloadGen.fill(payload, pattern_len);
+
+    scoreboard().sentPayload(payload, payloadlen, pUdp->UdpVpGetTicks());
+
+    // Configure a transmission
+    pktCfg.dst_port     = dst_port;
+    pktCfg.ip_dst_addr  = ip_dst_addr;
+    pktCfg.mac_dst_addr = mac_dst_addr;
+
+    // Generate a frame of data using configuration and payload
+    uint32_t len = pUdp->genUdpIpPkt (pktCfg, frmBuf, payload, payloadlen);
+
+    // Transmit packet over node's bus
+    pUdp->UdpVpSendRawEthFrame (frmBuf, len);
+}
+
+// --------------------------------------------
+// Helper method to send UDP pattern messages
+// with FCS and runt faults each injected with
+// the given percentage probability. Returns the
+// number of messages faulted.
+// --------------------------------------------
+uint32_t udpTest0::sendFaultedMessages(const uint32_t fault_pct, const uint32_t seed)
+{
+    udpFaultInject faults(seed, node);
+    uint32_t       faulted = 0;
+
+    faults.setRate(udpFaultInject::FAULT_FCS,  fault_pct / 100.0);
+    faults.setRate(udpFaultInject::FAULT_RUNT, fault_pct / 100.0);
+
+    pUdp->UdpVpSetFaultInject(&faults);
+
+    for (int idx = 0; idx < FAULT_MESSAGES; idx++)
+    {
+        // A message may have both faults, but is only lost once
+        uint64_t count = faults.getCount(udpFaultInject::FAULT_FCS) + faults.getCount(udpFaultInject::FAULT_RUNT);
+
+        sendPatternMessage(256, UDP_PORT_NUM+1, SERVER_IPV4_ADDR, SERVER_MAC_ADDR, pUdp);
+        pUdp->UdpVpSendIdle(20);
+
+        if (faults.getCount(udpFaultInject::FAULT_FCS) + faults.getCount(udpFaultInject::FAULT_RUNT) != count)
+        {
+            faulted++;
+        }
+    }
+
+    pUdp->UdpVpSetFaultInject(NULL);
+
+    faults.printStats();
+
+    return faulted;
+}
+
 // --------------------------------------------
 // Top level test method
 // --------------------------------------------
@@ -94,6 +155,35 @@ uint32_t udpTest0::runTest()
     // Wait a bit
     pUdp->UdpVpSendIdle(20);
 
+    // Send PRBS31 pattern messages, seeded from any +seed=<n> plusarg
+    uint32_t seed = getSeed(0x1234567);
+
+    VPrint("Node%d: seed %u\n\n", node, seed);
+
+    payloadGen.setPattern(udpPayload::PRBS31, node, seed);
+
+    for (int idx = 0; idx < 2; idx++)
+    {
+        sendPatternMessage(256, UDP_PORT_NUM+1, SERVER_IPV4_ADDR, SERVER_MAC_ADDR, pUdp);
+        pUdp->UdpVpSendIdle(20);
+    }
+
+    // With a +faults=<percent> plusarg (or UDP_FAULTS), send more pattern messages with
+    // faults injected, seeded from the test seed
+    uint32_t fault_pct = getOption("faults", "UDP_FAULTS", 0);
+    uint32_t faulted   = 0;
+
+    if (fault_pct)
+    {
+        faulted = sendFaultedMessages(fault_pct, seed);
+    }
+
+    // Check all the pattern messages arrived intact, other than those faulted, which
+    // node 1 must have lost
+    scoreboard().setExpectedLost(faulted);
+    scoreboard().finalise();
+    scoreboard().printReport();
+
     // Request simulation to finish
     pUdp->UdpVpSetHalt(1);
 
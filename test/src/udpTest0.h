@@ -28,6 +28,7 @@
 
 #include "udpTestBase.h"
 #include "udpCommon.h"
+#include "udpPayload.h"
 
 class udpTest0 : public udpTestBase
 {
@@ -39,14 +40,29 @@ public:
     uint32_t runTest     ();
     
 private:
+    // Number of pattern messages sent with faults injected
+    static const int FAULT_MESSAGES = 32;
+
     uint32_t payload [PKTBUFSIZE];
     uint32_t frmBuf  [PKTBUFSIZE];
+
+    // Pattern payload generator
+    udpPayload payloadGen;
     
     void sendTextMessage(const char*    mess_str, 
                          const uint32_t dst_port, 
                          const uint32_t ip_dst_addr, 
                          const uint64_t mac_dst_addr, 
                          udpIpPg*       pUdp);
+
+    void sendPatternMessage(const uint32_t pattern_len,
+                            const uint32_t dst_port,
+                            const uint32_t ip_dst_addr,
+                            const uint64_t mac_dst_addr,
+                            udpIpPg*       pUdp);
+
+    uint32_t sendFaultedMessages(const uint32_t fault_pct,
+                                 const uint32_t seed);
 };
 
 #endif
\ No newline at end of file
@@ -34,10 +34,17 @@ static char sbuf [udpIpPg::ETH_MTU];
 
 uint32_t udpTest1::runTest()
 {
-    udpIpPg::rxInfo_t pkt;
-
     pUdp = new udpIpPg(node, SERVER_IPV4_ADDR, SERVER_MAC_ADDR, UDP_PORT_NUM);
 
+#ifdef UDP_CORO
+    // The scheduler takes over the RX callback, and runs the server
+    createScheduler();
+
+    pSched->spawn(server(*pSched));
+    pSched->run();
+#else
+    udpIpPg::rxInfo_t pkt;
+
     // Register RX call back function
     pUdp->registerUsrRxCbFunc(rxCallback, (void*)this);
     
@@ -46,24 +53,57 @@ uint32_t udpTest1::runTest()
         // Wait for Packet
         while(rxQueue.empty())
         {
-            pUdp->UdpVpSendIdle(20);
+            pUdp->waitForRx();
         }
         
         pkt = rxQueue.front();
         rxQueue.erase(rxQueue.begin());
-        
-        // Process any packet data
-        if (pkt.rx_len)
-        {
-            for(int idx = 0; idx < pkt.rx_len; idx++)
-            {
-                sbuf[idx] = pkt.rx_payload[idx];
-            }
-            sbuf[pkt.rx_len] = 0;
-            VPrint("Node%d: %s\n", node, sbuf);
-        }
-    }
 
+        processPkt(pkt);
+    }
+#endif
 
     return 0;
-}
\ No newline at end of file
+}
+
+#ifdef UDP_CORO
+// --------------------------------------------
+// Server task, displaying and processing each
+// packet as it is received
+// --------------------------------------------
+
+udpTask udpTest1::server(udpScheduler& s)
+{
+    while (true)
+    {
+        udpScheduler::rxResult_t rx = co_await s.recv();
+
+        printRxPkt(rx.pkt, node, rx.tick);
+        processPkt(rx.pkt);
+    }
+}
+#endif
+
+// --------------------------------------------
+// --------------------------------------------
+
+void udpTest1::processPkt(udpIpPg::rxInfo_t &pkt)
+{
+    // Check any pattern payload
+    if (udpPayload::isPatternPayload(pkt.rx_payload, pkt.rx_len))
+    {
+        uint32_t errors = payloadChk.check(pkt.rx_payload, pkt.rx_len);
+        scoreboard().receivedPayload(pkt.rx_payload, pkt.rx_len, pUdp->UdpVpGetTicks());
+        VPrint("Node%d: pattern payload of %d bytes with %d byte errors\n\n", node, pkt.rx_len, errors);
+    }
+    // Process any packet data
+    else if (pkt.rx_len)
+    {
+        for(int idx = 0; idx < pkt.rx_len; idx++)
+        {
+            sbuf[idx] = pkt.rx_payload[idx];
+        }
+        sbuf[pkt.rx_len] = 0;
+        VPrint("Node%d: %s\n", node, sbuf);
+    }
+}
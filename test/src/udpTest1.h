@@ -27,17 +27,42 @@
 #include <vector>
 
 #include "udpTestBase.h"
+#include "udpCoro.h"
+#include "udpPayload.h"
 
+// With coroutine support (C++20), the server runs as a task on the
+// node's scheduler, else it polls for received packets
+#ifdef UDP_CORO
+class udpTest1 : public udpCoroTestBase
+#else
 class udpTest1 : public udpTestBase
+#endif
 {
 public:
 
     // Constructor
+#ifdef UDP_CORO
+    udpTest1(int nodeIn) : udpCoroTestBase(nodeIn) {};
+#else
     udpTest1(int nodeIn) : udpTestBase(nodeIn) {};
+#endif
 
     // Test method specific to this class
     uint32_t runTest     ();
 
+private:
+
+#ifdef UDP_CORO
+    // Server task
+    udpTask  server      (udpScheduler& s);
+#endif
+
+    // Method to process a received packet
+    void     processPkt  (udpIpPg::rxInfo_t &pkt);
+
+    // Pattern payload checker
+    udpPayload payloadChk;
+
 };
 
 #endif
\ No newline at end of file
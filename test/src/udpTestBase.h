@@ -24,7 +24,15 @@
 #ifndef _UDP_TEST_BASE_H_
 #define _UDP_TEST_BASE_H_
 
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
 #include "udpPrintPkt.h"
+#include "udpScoreboard.h"
+#include "udpRfc2544.h"
+#include "udpFileXfer.h"
 
 class udpTestBase : public udpPrintPkt
 {
@@ -38,19 +46,104 @@ public:
     // Virtual function to be provided by the derived test class
     virtual uint32_t runTest     () = 0;
 
+    // Method to return a numeric test option, from a +<name>=<n> simulator plusarg, or
+    // the given environment variable, else the given default
+    static uint32_t getOption(const char* name, const char* envName, uint32_t defaultVal)
+    {
+        uint32_t val                   = defaultVal;
+        char*    env                   = getenv(envName);
+        size_t   namelen               = strlen(name);
+        FILE*    fp;
+
+        if (env != NULL)
+        {
+            val                        = strtoul(env, NULL, 0);
+        }
+
+        // Plusargs are on the simulator's command line, so look for one there
+        if ((fp = fopen("/proc/self/cmdline", "rb")) != NULL)
+        {
+            char arg[256];
+            int  c, idx                = 0;
+
+            while ((c = fgetc(fp)) != EOF)
+            {
+                if (c == 0 || idx == sizeof(arg)-1)
+                {
+                    arg[idx]           = 0;
+                    if (arg[0] == '+' && !strncmp(&arg[1], name, namelen) && arg[namelen+1] == '=')
+                    {
+                        val            = strtoul(&arg[namelen+2], NULL, 0);
+                    }
+                    idx                = 0;
+                }
+                else
+                {
+                    arg[idx++]         = c;
+                }
+            }
+            fclose(fp);
+        }
+
+        return val;
+    }
+
+    // Method to return the test's random seed, from a +seed=<n> simulator plusarg, or
+    // the UDP_SEED environment variable, else the given default
+    static uint32_t getSeed(uint32_t defaultSeed) {return getOption("seed", "UDP_SEED", defaultSeed);}
+
+    // Method to return the scoreboard shared by all the nodes' tests
+    static udpScoreboard& scoreboard()
+    {
+        static udpScoreboard sb;
+        return sb;
+    }
+
+    // Method to return the RFC 2544 benchmark driver shared by all the nodes' tests
+    static udpRfc2544& rfc2544()
+    {
+        static udpRfc2544 rfc;
+        return rfc;
+    }
+
+    // Method to return the file transfer shared by the sending and receiving nodes
+    static udpFileXfer& fileXfer()
+    {
+        static udpFileXfer xfer;
+        return xfer;
+    }
+
     // Simulation control methods
     void            sleepForever() {if (pUdp != NULL) while(true) pUdp->UdpVpSendIdle(20000000);};
     void            haltSim     () {if (pUdp != NULL) pUdp->UdpVpSetHalt(1);};
 
+    // Method to pass RFC 2544 test frames and file transfer datagrams to their
+    // shared objects. These are counted, but not displayed or queued. Returns
+    // true if the packet was taken.
+    static bool     divertRx   (const udpIpPg::rxInfo_t &rx_info, udpIpPg* pUdpIn)
+    {
+        if (udpRfc2544::isTestPayload(rx_info.rx_payload, rx_info.rx_len))
+        {
+            rfc2544().received(rx_info.rx_payload, rx_info.rx_len, pUdpIn->UdpVpGetTicks());
+            return true;
+        }
+
+        return fileXfer().received(rx_info.rx_payload, rx_info.rx_len);
+    }
+
     // Callback function needs to be static to allow it to be used as an
     // argument in the callback registration function. It will be passed
     // the 'this' pointer of its class object in hdl, so can access methods
     // via this pointer.
     static void     rxCallback (udpIpPg::rxInfo_t rx_info, void* hdl)
     {
+        if (divertRx(rx_info, ((udpTestBase*)hdl)->pUdp))
+        {
+            return;
+        }
 
         // Display the received packet
-        ((udpTestBase*)hdl)->printRxPkt(rx_info, ((udpTestBase*)hdl)->node);
+        ((udpTestBase*)hdl)->printRxPkt(rx_info, ((udpTestBase*)hdl)->node, ((udpTestBase*)hdl)->pUdp->UdpVpGetTicks());
 
         // Append packet to the receive queue
         ((udpTestBase*)hdl)->rxQueue.push_back(rx_info);
@@ -37,19 +37,30 @@
 module tb
 #(parameter GUI_RUN          = 0,
   parameter CLK_FREQ_KHZ     = 125000,
-  parameter VCD_DUMP         = 0,
+  parameter VCD_DUMP         = 0,  // 0 = none, 1 = whole run, 2 = windows controlled by software
+  parameter FST_DUMP         = 0,  // Name dump file waves.fst (e.g. with Verilator --trace-fst, or vvp -fst)
+  parameter WIDE             = 0,  // 1 = nodes transfer 4 bytes per VProc access
   parameter DEBUG_STOP       = 0
   )
-();
+(
+// With TB_EXT_CLK defined, the clock is driven externally (e.g. by
+// tb_main.cpp for a Verilator build without --timing)
+`ifdef TB_EXT_CLK
+  input          clk
+`endif
+);
 
 localparam  RESET_PERIOD     = 10;
 localparam  TIMEOUT_COUNT    = 400000;
 
 // Clock, reset and simulation control state
+`ifndef TB_EXT_CLK
 reg            clk;
+`endif
 integer        count;
 
 wire  [1:0]    halt;
+wire  [1:0]    trace;
 
 wire  [7:0]    txd0,  txd1;
 wire           txen0, txen1;
@@ -72,11 +83,20 @@ initial
 begin
    if (VCD_DUMP != 0)
    begin
-     $dumpfile("waves.vcd");
+     if (FST_DUMP != 0)
+       $dumpfile("waves.fst");
+     else
+       $dumpfile("waves.vcd");
      $dumpvars(0, tb);
+
+     // When software controlled, start with dumping off
+     if (VCD_DUMP == 2)
+       $dumpoff;
    end
 
+`ifndef TB_EXT_CLK
    clk                                 = 1'b1;
+`endif
    count                               = -1;
 
 `ifndef VERILATOR
@@ -91,19 +111,26 @@ begin
      $stop;
    end
 
+`ifndef TB_EXT_CLK
    // Generate a clock
    forever #(500000000.0/CLK_FREQ_KHZ) clk = ~clk;
+`endif
 end
 
-`ifdef VERILATOR
-reg clkx2;
-initial
+// -----------------------------------------------
+// Software controlled waveform dump windows, with
+// dumping on whilst either node requests it
+// -----------------------------------------------
+always @(trace)
 begin
-  clkx2                                = 1'b0;
-  // Generate a double frequency clock
-  forever #(250000000.0/CLK_FREQ_KHZ) clkx2 = ~clkx2;
+  if (VCD_DUMP == 2)
+  begin
+    if (|trace)
+      $dumpon;
+    else
+      $dumpoff;
+  end
 end
-`endif
 
 // -----------------------------------------------
 // Simulation control process
@@ -130,7 +157,7 @@ end
 // UDP/IPv4 node 0
 // -----------------------------------------------
 
-  udp_ip_pg #(.NODE(0)) node0
+  udp_ip_pg #(.NODE(0), .WIDE(WIDE)) node0
   (
     .clk                     (clk),
 
@@ -142,7 +169,8 @@ end
     .rxdv                    (rxdv0),
     .rxer                    (rxer0),
 
-    .halt                    (halt[0])
+    .halt                    (halt[0]),
+    .trace                   (trace[0])
   );
 
 `ifdef RGMII
@@ -154,10 +182,6 @@ end
   (
     .clk                       (clk),
 
-`ifdef VERILATOR
-    .clkx2                     (clkx2),
-`endif
-
     .gmiitxd                   (txd0),
     .gmiitxen                  (txen0),
     .gmiitxer                  (txer0),
@@ -182,10 +206,6 @@ end
   (
     .clk                       (clk),
 
-`ifdef VERILATOR
-    .clkx2                     (clkx2),
-`endif
-
     .gmiitxd                   (txd1),
     .gmiitxen                  (txen1),
     .gmiitxer                  (txer1),
@@ -215,7 +235,7 @@ assign rxer0 = txer1;
 // UDP/IPv4 node 1
 // -----------------------------------------------
 
-  udp_ip_pg #(.NODE(1)) node1
+  udp_ip_pg #(.NODE(1), .WIDE(WIDE)) node1
   (
     .clk                     (clk),
 
@@ -227,7 +247,8 @@ assign rxer0 = txer1;
     .rxdv                    (rxdv1),
     .rxer                    (rxer1),
 
-    .halt                    (halt[1])
+    .halt                    (halt[1]),
+    .trace                   (trace[1])
   );
 
 endmodule
\ No newline at end of file
@@ -39,6 +39,7 @@ entity tb is
 generic (GUI_RUN          : integer := 0;
          CLK_FREQ_KHZ     : real    := 125000.0;
          VCD_DUMP         : integer := 0;
+         WIDE             : integer := 0;  -- 1 = nodes transfer 4 bytes per VProc access
          DEBUG_STOP       : integer := 0
   );
 end entity;
@@ -116,7 +117,8 @@ begin
 
   node0 : entity work.udp_ip_pg
   generic map (
-    NODE_NUM                 => 0
+    NODE_NUM                 => 0,
+    WIDE                     => WIDE
   )
   port map (
      clk                     => clk,
@@ -184,7 +186,8 @@ begin
 
   node1 : entity work.udp_ip_pg
   generic map (
-    NODE_NUM                 => 1
+    NODE_NUM                 => 1,
+    WIDE                     => WIDE
   )
   port map (
      clk                     => clk,
@@ -0,0 +1,61 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Verilator top level for the performance build profile
+// (make -f makefile.verilator perf), where the design is built
+// without --timing. The test bench is compiled with TB_EXT_CLK
+// defined, and its clock is driven from here.
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <memory>
+
+#include "verilated.h"
+#include "Vtb.h"
+
+// Half period of the 125MHz clock, in the test bench's 1ps time units
+static const uint64_t HALF_PERIOD_PS = 4000;
+
+// ---------------------------------------------
+// Main entry point
+// ---------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+
+    contextp->commandArgs(argc, argv);
+
+    const std::unique_ptr<Vtb> top{new Vtb{contextp.get()}};
+
+    // Start high, as for the internally generated clock
+    top->clk = 1;
+    top->eval();
+
+    while (!contextp->gotFinish())
+    {
+        contextp->timeInc(HALF_PERIOD_PS);
+        top->clk = !top->clk;
+        top->eval();
+    }
+
+    top->final();
+
+    return 0;
+}
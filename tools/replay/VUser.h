@@ -0,0 +1,48 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Stand-in for the VProc user API, for building the node
+// code natively to replay recorded VProc transactions (see
+// udpReplay.cpp). The node's accesses go to the replay
+// transport, so only VTick() (called by test code waiting
+// forever) is defined, by udpReplay.cpp.
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#ifndef _VUSER_H_
+#define _VUSER_H_
+
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int  VWrite (unsigned int addr, unsigned int  data, int delta, uint32_t node);
+extern int  VRead  (unsigned int addr, unsigned int* data, int delta, uint32_t node);
+extern int  VTick  (uint32_t ticks, uint32_t node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define VPrint(...) printf(__VA_ARGS__)
+
+#endif
@@ -0,0 +1,220 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// External end of a udpBridge, connecting a simulated node to
+// a Linux TAP interface. Build with:
+//
+//   g++ -O2 -I../src -o udpBridgeTap udpBridgeTap.cpp ../src/udpBridgePort.cpp -lrt
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_tun.h>
+
+#include "udpBridgePort.h"
+
+// Sleep when there is nothing to do, and between attempts to attach
+static const uint32_t IDLE_SLEEP_US            = 50;
+static const uint32_t ATTACH_SLEEP_US          = 100000;
+
+static volatile sig_atomic_t running           = 1;
+
+static void stop (int sig)
+{
+    running                                    = 0;
+}
+
+// ---------------------------------------------
+// Open a TAP interface, returning a non-blocking
+// file descriptor, or -1 on error
+// ---------------------------------------------
+
+static int openTap (const char* tapname)
+{
+    int fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+
+    ifr.ifr_flags                              = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, tapname, IFNAMSIZ-1);
+
+    if (ioctl(fd, TUNSETIFF, &ifr) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+// ---------------------------------------------
+// Usage: udpBridgeTap [-t <tap name>] [-s | -u] [-e] <bridge name>
+//
+//   -t : TAP interface to use (default tap0)
+//   -s : shared memory transport only
+//   -u : Unix socket transport only
+//   -e : echo frames back to the simulation, with the
+//        MAC addresses swapped, instead of using a TAP
+// ---------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const char* tapname                        = "tap0";
+    const char* name                           = NULL;
+    uint32_t    transport                      = udpBridgePort::TRANSPORT_AUTO;
+    bool        echo                           = false;
+
+    for (int idx = 1; idx < argc; idx++)
+    {
+        if (!strcmp(argv[idx], "-t") && idx+1 < argc)
+        {
+            tapname                            = argv[++idx];
+        }
+        else if (!strcmp(argv[idx], "-s"))
+        {
+            transport                          = udpBridgePort::TRANSPORT_SHM;
+        }
+        else if (!strcmp(argv[idx], "-u"))
+        {
+            transport                          = udpBridgePort::TRANSPORT_SOCKET;
+        }
+        else if (!strcmp(argv[idx], "-e"))
+        {
+            echo                               = true;
+        }
+        else
+        {
+            name                               = argv[idx];
+        }
+    }
+
+    if (name == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-t <tap name>] [-s | -u] [-e] <bridge name>\n", argv[0]);
+        return 1;
+    }
+
+    int tapfd                                  = -1;
+
+    if (!echo && (tapfd = openTap(tapname)) < 0)
+    {
+        fprintf(stderr, "%s: ***ERROR. Unable to open TAP interface %s\n", argv[0], tapname);
+        return 1;
+    }
+
+    signal(SIGINT,  stop);
+    signal(SIGTERM, stop);
+
+    // Wait for the simulation to open its end of the bridge
+    udpBridgePort port;
+
+    while (running && !port.open(name, udpBridgePort::ROLE_PEER, transport))
+    {
+        usleep(ATTACH_SLEEP_US);
+    }
+
+    if (running)
+    {
+        fprintf(stderr, "%s: attached to bridge %s (%s)\n", argv[0], name,
+                port.getTransport() == udpBridgePort::TRANSPORT_SHM ? "shared memory" : "socket");
+    }
+
+    uint8_t  buf[udpBridgePort::MAX_FRAME_LEN];
+    uint64_t to_sim                            = 0;
+    uint64_t from_sim                          = 0;
+    uint64_t dropped                           = 0;
+
+    while (running)
+    {
+        bool busy                              = false;
+
+        // Simulation to TAP (or echoed back)
+        uint32_t len                           = port.recv(buf);
+
+        if (len)
+        {
+            busy                               = true;
+            from_sim++;
+
+            if (echo)
+            {
+                uint8_t mac[6];
+                memcpy(mac,     buf,     6);
+                memcpy(buf,     buf + 6, 6);
+                memcpy(buf + 6, mac,     6);
+
+                if (port.send(buf, len)) to_sim++; else dropped++;
+            }
+            else if (write(tapfd, buf, len) != (ssize_t)len)
+            {
+                dropped++;
+            }
+        }
+
+        // TAP to simulation
+        if (!echo)
+        {
+            ssize_t rlen                       = read(tapfd, buf, sizeof(buf));
+
+            if (rlen > 0)
+            {
+                busy                           = true;
+
+                if (port.send(buf, rlen)) to_sim++; else dropped++;
+            }
+        }
+
+        // A socket peer is finished when the simulation closes its end
+        if (port.getTransport() == udpBridgePort::TRANSPORT_SOCKET && !port.connected())
+        {
+            break;
+        }
+
+        if (!busy)
+        {
+            usleep(IDLE_SLEEP_US);
+        }
+    }
+
+    fprintf(stderr, "%s: %lu frames to simulation, %lu from simulation, %lu dropped\n",
+            argv[0], (unsigned long)to_sim, (unsigned long)from_sim, (unsigned long)dropped);
+
+    port.close();
+
+    if (tapfd >= 0)
+    {
+        close(tapfd);
+    }
+
+    return 0;
+}
@@ -0,0 +1,313 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Impaired link between two bridged nodes (see udpBridge),
+// using udpLinkModel. Build with:
+//
+//   g++ -O2 -I../src -o udpLinkBridge udpLinkBridge.cpp ../src/udpLinkModel.cpp ../src/udpBridgePort.cpp -lrt
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <chrono>
+
+#include "udpLinkModel.h"
+#include "udpBridgePort.h"
+
+// Sleep when there is nothing to do, and between attempts to attach
+static const uint32_t IDLE_SLEEP_US            = 20;
+static const uint32_t ATTACH_SLEEP_US          = 100000;
+
+static volatile sig_atomic_t running           = 1;
+
+static void stop (int sig)
+{
+    running                                    = 0;
+}
+
+// ---------------------------------------------
+// Deliver a frame from the link to the bridge
+// at its far end
+// ---------------------------------------------
+
+static void deliver (uint32_t dir, const uint8_t* frame, uint32_t len, void* hdl)
+{
+    udpBridgePort* ports                       = (udpBridgePort*)hdl;
+
+    ports[dir == udpLinkModel::DIR_A_TO_B ? 1 : 0].send(frame, len);
+}
+
+// ---------------------------------------------
+// Microseconds since the start of the run
+// ---------------------------------------------
+
+static uint64_t nowUs (void)
+{
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ---------------------------------------------
+// Checks of the link model. A frame with a short
+// delay must not be held behind a longer delayed
+// frame in the other direction, and a reply sent
+// from the delivery callback with no delay must be
+// delivered on the same tick. Returns true if the
+// frames are delivered when due.
+// ---------------------------------------------
+
+static uint64_t check_tick;
+static uint64_t check_delivered[2];
+
+static void checkDeliver (uint32_t dir, const uint8_t* frame, uint32_t len, void* hdl)
+{
+    check_delivered[dir]                       = check_tick;
+
+    // Reply from B to A, if a link to reply on is given
+    if (hdl != NULL && dir == udpLinkModel::DIR_A_TO_B)
+    {
+        ((udpLinkModel*)hdl)->send(udpLinkModel::DIR_B_TO_A, frame, len, check_tick);
+    }
+}
+
+static bool checkDelays (const char* name, uint32_t delay_ab, uint32_t delay_ba, bool reply,
+                         uint64_t expect_ab, uint64_t expect_ba)
+{
+    udpLinkModel::linkConfig_t cfg             = udpLinkModel::idealConfig();
+    udpLinkModel               link(1);
+    uint8_t                    frame[64]       = {0};
+
+    cfg.delay                                  = delay_ab;
+    link.setConfig(udpLinkModel::DIR_A_TO_B, cfg);
+    cfg.delay                                  = delay_ba;
+    link.setConfig(udpLinkModel::DIR_B_TO_A, cfg);
+
+    link.registerDeliverCb(checkDeliver, reply ? &link : NULL);
+
+    check_delivered[0]                         = 0;
+    check_delivered[1]                         = 0;
+
+    for (check_tick = 0; check_tick < 2000; check_tick++)
+    {
+        if (check_tick == 100)
+        {
+            link.send(udpLinkModel::DIR_A_TO_B, frame, sizeof(frame), check_tick);
+        }
+        else if (check_tick == 200 && !reply)
+        {
+            link.send(udpLinkModel::DIR_B_TO_A, frame, sizeof(frame), check_tick);
+        }
+
+        link.advance(check_tick);
+    }
+
+    bool pass                                  = check_delivered[udpLinkModel::DIR_A_TO_B] == expect_ab &&
+                                                 check_delivered[udpLinkModel::DIR_B_TO_A] == expect_ba;
+
+    printf("Link model check (%s): A->B delivered at %lu (expected %lu), B->A at %lu (expected %lu) : %s\n", name,
+           (unsigned long)check_delivered[udpLinkModel::DIR_A_TO_B], (unsigned long)expect_ab,
+           (unsigned long)check_delivered[udpLinkModel::DIR_B_TO_A], (unsigned long)expect_ba, pass ? "PASS" : "FAIL");
+
+    return pass;
+}
+
+static bool checkModel (void)
+{
+    bool pass                                  = checkDelays("delays", 1000, 10, false, 1100, 210);
+
+    pass                                       = checkDelays("reply", 5, 0, true, 105, 105) && pass;
+
+    return pass;
+}
+
+// ---------------------------------------------
+// Usage: udpLinkBridge [options] <bridge A> <bridge B>
+//
+//   -d <us>                : delay
+//   -D <us>                : delay from B to A, if different
+//   -j <us>                : maximum jitter
+//   -l <prob>              : Bernoulli loss
+//   -g <p>,<r>,<good>,<bad> : Gilbert-Elliott loss (transition and loss probabilities)
+//   -r <prob>,<us>         : reordering, holding frames back by the given time
+//   -u <prob>              : duplication
+//   -s <seed>              : random seed
+//   -t                     : check the link model and exit
+//
+// Times are in microseconds of wall clock time, and the
+// impairments apply in both directions.
+// ---------------------------------------------
+
+int main(int argc, char** argv)
+{
+    udpLinkModel::linkConfig_t cfg             = udpLinkModel::idealConfig();
+    uint64_t                   seed            = 1;
+    int64_t                    delay_ba        = -1;
+    const char*                names[2]        = {NULL, NULL};
+    uint32_t                   num_names       = 0;
+    bool                       error           = false;
+
+    for (int idx = 1; idx < argc && !error; idx++)
+    {
+        const char* arg                        = argv[idx];
+        const char* val                        = (idx+1 < argc) ? argv[idx+1] : NULL;
+
+        if (arg[0] != '-')
+        {
+            if (num_names == 2)
+            {
+                error                          = true;
+            }
+            else
+            {
+                names[num_names++]             = arg;
+            }
+            continue;
+        }
+
+        if (!strcmp(arg, "-t"))
+        {
+            return checkModel() ? 0 : 1;
+        }
+
+        if (val == NULL)
+        {
+            error                              = true;
+            break;
+        }
+
+        idx++;
+
+        if (!strcmp(arg, "-d"))
+        {
+            cfg.delay                          = strtoul(val, NULL, 0);
+        }
+        else if (!strcmp(arg, "-D"))
+        {
+            delay_ba                           = strtoul(val, NULL, 0);
+        }
+        else if (!strcmp(arg, "-j"))
+        {
+            cfg.jitter                         = strtoul(val, NULL, 0);
+        }
+        else if (!strcmp(arg, "-l"))
+        {
+            cfg.loss_model                     = udpLinkModel::LOSS_BERNOULLI;
+            cfg.loss                           = atof(val);
+        }
+        else if (!strcmp(arg, "-g"))
+        {
+            cfg.loss_model                     = udpLinkModel::LOSS_GILBERT_ELLIOTT;
+            error                              = sscanf(val, "%lf,%lf,%lf,%lf", &cfg.ge_p, &cfg.ge_r,
+                                                        &cfg.ge_loss_good, &cfg.ge_loss_bad) != 4;
+        }
+        else if (!strcmp(arg, "-r"))
+        {
+            error                              = sscanf(val, "%lf,%u", &cfg.reorder, &cfg.reorder_delay) != 2;
+        }
+        else if (!strcmp(arg, "-u"))
+        {
+            cfg.duplicate                      = atof(val);
+        }
+        else if (!strcmp(arg, "-s"))
+        {
+            seed                               = strtoull(val, NULL, 0);
+        }
+        else
+        {
+            error                              = true;
+        }
+    }
+
+    if (error || num_names != 2)
+    {
+        fprintf(stderr, "Usage: %s [-t] [-d <us>] [-D <us>] [-j <us>] [-l <prob>] [-g <p>,<r>,<good>,<bad>] [-r <prob>,<us>] [-u <prob>] [-s <seed>]\n"
+                        "       <bridge A> <bridge B>\n", argv[0]);
+        return 1;
+    }
+
+    udpLinkModel link(seed);
+
+    link.setConfig(udpLinkModel::DIR_A_TO_B, cfg);
+
+    if (delay_ba >= 0)
+    {
+        cfg.delay                              = delay_ba;
+    }
+
+    link.setConfig(udpLinkModel::DIR_B_TO_A, cfg);
+
+    signal(SIGINT,  stop);
+    signal(SIGTERM, stop);
+
+    // Wait for both simulated nodes to open their bridges
+    udpBridgePort ports[2];
+
+    for (uint32_t idx = 0; idx < 2 && running; idx++)
+    {
+        while (running && !ports[idx].open(names[idx], udpBridgePort::ROLE_PEER))
+        {
+            usleep(ATTACH_SLEEP_US);
+        }
+    }
+
+    link.registerDeliverCb(deliver, (void*)ports);
+
+    uint8_t buf[udpBridgePort::MAX_FRAME_LEN];
+
+    while (running)
+    {
+        bool     busy                          = false;
+        uint64_t now                           = nowUs();
+
+        for (uint32_t idx = 0; idx < 2; idx++)
+        {
+            uint32_t len                       = ports[idx].recv(buf);
+
+            if (len)
+            {
+                busy                           = true;
+                link.send(idx == 0 ? udpLinkModel::DIR_A_TO_B : udpLinkModel::DIR_B_TO_A, buf, len, now);
+            }
+        }
+
+        link.advance(now);
+
+        // A socket peer is finished when either simulation closes its end
+        if ((ports[0].getTransport() == udpBridgePort::TRANSPORT_SOCKET && !ports[0].connected()) ||
+            (ports[1].getTransport() == udpBridgePort::TRANSPORT_SOCKET && !ports[1].connected()))
+        {
+            break;
+        }
+
+        if (!busy)
+        {
+            usleep(IDLE_SLEEP_US);
+        }
+    }
+
+    link.printStats(stderr);
+
+    return 0;
+}
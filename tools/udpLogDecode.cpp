@@ -0,0 +1,73 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Offline decoder for udpLog binary traces. Build with:
+//
+//   g++ -O2 -DUDP_LOG_NO_VPROC -I../src -o udpLogDecode udpLogDecode.cpp ../src/udpLog.cpp -pthread
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <stdio.h>
+#include <string.h>
+
+#include "udpLog.h"
+
+// ---------------------------------------------
+// Usage: udpLogDecode [-n] <trace file>
+//
+//   -n : do not prefix messages with tick, node and level
+// ---------------------------------------------
+
+int main(int argc, char** argv)
+{
+    bool        prefix                 = true;
+    const char* fname                  = NULL;
+
+    for (int idx = 1; idx < argc; idx++)
+    {
+        if (!strcmp(argv[idx], "-n"))
+        {
+            prefix                     = false;
+        }
+        else
+        {
+            fname                      = argv[idx];
+        }
+    }
+
+    if (fname == NULL)
+    {
+        fprintf(stderr, "Usage: %s [-n] <trace file>\n", argv[0]);
+        return 1;
+    }
+
+    FILE* fp = fopen(fname, "rb");
+
+    if (fp == NULL)
+    {
+        fprintf(stderr, "%s: ***ERROR. Unable to open %s for reading\n", argv[0], fname);
+        return 1;
+    }
+
+    int count = udpLog::decode(fp, stdout, prefix);
+
+    fclose(fp);
+
+    return (count < 0) ? 1 : 0;
+}
@@ -0,0 +1,137 @@
+//=============================================================
+//
+// Copyright (c) 2026 Simon Southwell. All rights reserved.
+//
+// Date: 18th October 2026
+//
+// Native replay of nodes' recorded VProc transactions (see
+// udpVpRecord), running the test code without the HDL. Build
+// from the test directory, with the stand-in VProc API and the
+// replay transport (see udpVpTransport.h), with:
+//
+//   g++ -g -DUDP_VP_TRANSPORT=udpVpReplayTransport -I../tools/replay -I../src -Isrc
+//       -o udpReplay ../tools/udpReplay.cpp src/VUserMain0.cpp src/VUserMain1.cpp src/udpTest0.cpp src/udpTest1.cpp ../src/*.cpp -pthread -lrt
+//
+// This code is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This code is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this code. If not, see <http://www.gnu.org/licenses/>.
+//
+//=============================================================
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "VUser.h"
+#include "udpVpRecord.h"
+#include "udpVpTransport.h"
+#include "udpLog.h"
+
+// Node entry points, as called by VProc
+extern "C" void VUserMain0();
+extern "C" void VUserMain1();
+
+static void (*const user_main[])(void) = {VUserMain0, VUserMain1};
+
+static const uint32_t MAX_NODES                = sizeof(user_main) / sizeof(user_main[0]);
+
+// Nodes that returned from their entry point
+static std::atomic<uint32_t> returned(0);
+
+// ---------------------------------------------
+// Stand-in VProc API. The nodes' HDL accesses go
+// to the replay transport, so this is only called
+// by test code waiting forever, as a node does at
+// the end of a simulation.
+// ---------------------------------------------
+
+extern "C" int VTick (uint32_t ticks, uint32_t node)
+{
+    udpVpReplayTransport::park();
+    return 0;
+}
+
+// ---------------------------------------------
+// Usage: udpReplay [-p <prefix>] [-n <nodes>] [+<plusarg>...]
+//
+//   -p <prefix> : recording file name prefix, with node N's
+//                 recording in <prefix>N.vprec (default node)
+//   -n <nodes>  : number of nodes to replay (default all)
+//
+// Plusargs (e.g. +seed=<n>) are seen by the test code as
+// on the simulator command line, and must match those of
+// the recorded run. Returns non-zero if a node's replay
+// differed from its recording.
+// ---------------------------------------------
+
+int main(int argc, char** argv)
+{
+    const char* prefix                         = "node";
+    uint32_t    num_nodes                      = MAX_NODES;
+    bool        error                          = false;
+
+    for (int idx = 1; idx < argc && !error; idx++)
+    {
+        if (argv[idx][0] == '+')
+        {
+            continue;
+        }
+
+        if (idx+1 >= argc)
+        {
+            error                              = true;
+        }
+        else if (!strcmp(argv[idx], "-p"))
+        {
+            prefix                             = argv[++idx];
+        }
+        else if (!strcmp(argv[idx], "-n"))
+        {
+            num_nodes                          = strtoul(argv[++idx], NULL, 0);
+            error                              = num_nodes == 0 || num_nodes > MAX_NODES;
+        }
+        else
+        {
+            error                              = true;
+        }
+    }
+
+    if (error)
+    {
+        fprintf(stderr, "Usage: %s [-p <prefix>] [-n <nodes (1 to %d)>] [+<plusarg>...]\n", argv[0], MAX_NODES);
+        return 1;
+    }
+
+    // Nodes start their replays when constructed
+    setenv("UDP_REPLAY", prefix, 1);
+    unsetenv("UDP_RECORD");
+
+    for (uint32_t node = 0; node < num_nodes; node++)
+    {
+        std::thread([node] {user_main[node](); returned++;}).detach();
+    }
+
+    while (udpVpRecord::replaysFinished() + udpVpReplayTransport::noRecordingCount() + returned < num_nodes)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    udpLog::instance().stop();
+    fflush(stdout);
+
+    return (udpVpRecord::replaysDiverged() || udpVpReplayTransport::noRecordingCount()) ? 1 : 0;
+}
@@ -32,6 +32,16 @@
 
 `define HoldDly                      100
 
+// Use the cycle-based model for Verilator, when no delays are
+// required, or if requested
+`ifdef VERILATOR
+`define RGMII_CYCLE_BASED
+`endif
+
+`ifdef UDP_IP_PG_NO_DELAY
+`define RGMII_CYCLE_BASED
+`endif
+
 // ============================================
 //  MODULE
 // ============================================
@@ -39,9 +49,6 @@
 module gmii_rgmii_conv
 (
   input                               clk,
-`ifdef VERILATOR
-  input                               clkx2,
-`endif
 
   // GMII to RGMII
   input      [7:0]                    gmiitxd,
@@ -60,40 +67,81 @@ module gmii_rgmii_conv
   output reg                          gmiirxer
 );
 
-reg   [3:0] gmiirxdlo;
-reg   [3:0] gmiirxdhi;
-reg         gmiirxdv_int;
-reg         gmiirxer_int;
+`ifdef RGMII_CYCLE_BASED
 
-reg   [7:0] gmiirxdneg;
-reg         gmiirxdvneg;
-reg         gmiirxerneg;
+// --------------------------------------------
+// Cycle-based model, with no delays and no
+// double rate clock. The GMII TX input is
+// sampled mid-cycle, clear of VProc updates on
+// the rising edge, and each nibble is driven
+// from a register on the clock edge starting its
+// half cycle. The receiver samples each nibble on
+// the edge ending its half cycle. The GMII to
+// GMII latency, and nibble order, are as for the
+// delay based model below, and the two
+// interoperate.
+// --------------------------------------------
 
-`ifdef VERILATOR
+reg   [3:0] rgmiitxd_reg;
+reg         rgmiitxctl_reg;
+reg   [3:0] txdlo;
+reg   [3:0] txdhi;
+reg         txen;
+reg         txer;
 
-reg   [3:0] rgmiitxd90;
-reg         rgmiitxctl90;
+reg   [3:0] gmiirxdlo;
+reg         gmiirxdv_int;
 
-always @(posedge clkx2)
+assign rgmiitxd                    = rgmiitxd_reg;
+assign rgmiitxctl                  = rgmiitxctl_reg;
+
+always @(posedge clk)
 begin
-  rgmiitxd90                       <= clk ? gmiitxd[3:0] : gmiitxd[7:4];
-  rgmiitxctl90                     <= clk ? gmiitxen     : gmiitxer;
+  // Drive the low nibble and enable of the sampled GMII TX byte
+  rgmiitxd_reg                     <= txdlo;
+  rgmiitxctl_reg                   <= txen;
+
+  // Sample the high nibble RX input, and output with the low nibble
+  gmiirxd                          <= {rgmiirxd, gmiirxdlo};
+  gmiirxdv                         <= gmiirxdv_int;
+  gmiirxer                         <= rgmiirxctl;
 end
 
-assign rgmiitxd                    = rgmiitxd90;
-assign rgmiitxctl                  = rgmiitxctl90;
+always @(negedge clk)
+begin
+  // Drive the high nibble and error of the sampled GMII TX byte,
+  // and sample the next
+  rgmiitxd_reg                     <= txdhi;
+  rgmiitxctl_reg                   <= txer;
+
+  txdlo                            <= gmiitxd[3:0];
+  txdhi                            <= gmiitxd[7:4];
+  txen                             <= gmiitxen;
+  txer                             <= gmiitxer;
+
+  // Sample the low nibble RX input
+  gmiirxdlo                        <= rgmiirxd;
+  gmiirxdv_int                     <= rgmiirxctl;
+end
 
 `else
 
+reg   [3:0] gmiirxdlo;
+reg   [3:0] gmiirxdhi;
+reg         gmiirxdv_int;
+reg         gmiirxer_int;
+
+reg   [7:0] gmiirxdneg;
+reg         gmiirxdvneg;
+reg         gmiirxerneg;
+
 // Time-division multiplex the GMII TX input onto RGMII
-// with a hold delay (needed, even for Verilator, since using clock
-// as mux control, and must ensure signals are sample corrrectly
+// with a hold delay (needed since using clock as mux
+// control, and must ensure signals are sample corrrectly
 // at destination).
 assign #`HoldDly rgmiitxd          = clk ? gmiitxd[3:0] : gmiitxd[7:4];
 assign #`HoldDly rgmiitxctl        = clk ? gmiitxen     : gmiitxer;
 
-`endif
-
 always @(posedge clk)
 begin
   // Sample high nibble RX input
@@ -118,4 +166,6 @@ begin
   gmiirxerneg                      <= gmiirxer_int;
 end
 
+`endif
+
 endmodule
\ No newline at end of file
@@ -34,26 +34,41 @@
 `define TXC_ADDR                      32'h1
 `define TICKS_ADDR                    32'h2
 `define HLT_ADDR                      32'h3
+`define TRC_ADDR                      32'h4
+`define LNS_ADDR                      32'h5
+`define WTXD_ADDR                     32'h6
+`define WTXC_ADDR                     32'h7
 
 // ============================================
 //  MODULE
 // ============================================
 
+// With WIDE set, VProc runs at a quarter of the clock rate and
+// transfers 4 bytes, and 4 control lane pairs, per access on the
+// WTXD and WTXC registers, which are serialised onto, and
+// deserialised from, GMII. Byte lane 0 (bits 7:0, controls 1:0)
+// is first on the wire. The LNS register returns the number of
+// lanes per access (1 when WIDE is clear).
+
 module udp_ip_pg
-#(parameter                            NODE    = 0)
+#(parameter                            NODE    = 0,
+  parameter                            WIDE    = 0)
 (
   input                                clk,
 
   // GMII interface
-  output reg  [7:0]                    txd,
-  output reg                           txen,
-  output reg                           txer,
+  output      [7:0]                    txd,
+  output                               txen,
+  output                               txer,
 
   input       [7:0]                    rxd,
   input                                rxdv,
   input                                rxer,
 
-  output reg                           halt
+  output reg                           halt,
+
+  // Waveform trace enable, for use by the test bench
+  output reg                           trace
 );
 
 // --------------------------------------------
@@ -71,6 +86,29 @@ reg  [31:0] DataIn;
 wire        Update;
 reg         UpdateResponse;
 
+// Byte wide mode TX outputs
+reg   [7:0] txd_n;
+reg         txen_n;
+reg         txer_n;
+
+// Wide mode TX and RX words, serialiser/deserialiser state,
+// and the VProc clock
+wire [31:0] lanes   = WIDE ? 32'd4 : 32'd1;
+reg  [31:0] tx_word;
+reg   [7:0] tx_ctl;
+reg  [23:0] tx_shift;
+reg   [5:0] txc_shift;
+reg   [7:0] txd_w;
+reg         txen_w;
+reg         txer_w;
+reg  [23:0] rx_shift;
+reg   [5:0] rxc_shift;
+reg  [31:0] rx_word;
+reg   [7:0] rxc_word;
+reg   [1:0] phase;
+reg         vp_clk;
+wire        vproc_clk = WIDE ? vp_clk : clk;
+
 // --------------------------------------------
 // Continuous assignments
 // --------------------------------------------
@@ -78,8 +116,14 @@ reg         UpdateResponse;
 // Ensure there is no race on the update ordering on
 // the rising edge of the clock between updating the
 // inputs and the synchronous process below being called.
+// Delay free sampling on the falling edge is used for
+// Verilator, or if UDP_IP_PG_NO_DELAY is defined.
 
-`ifndef VERILATOR
+`ifdef VERILATOR
+`define UDP_IP_PG_NO_DELAY
+`endif
+
+`ifndef UDP_IP_PG_NO_DELAY
 
 wire  [7:0] rxd_int;
 wire  [1:0] rxc_int;
@@ -100,6 +144,11 @@ end
 
 `endif
 
+// Select the TX outputs for the mode
+assign txd                             = WIDE ? txd_w  : txd_n;
+assign txen                            = WIDE ? txen_w : txen_n;
+assign txer                            = WIDE ? txer_w : txer_n;
+
 // --------------------------------------------
 // Initialisation
 // --------------------------------------------
@@ -107,11 +156,25 @@ end
 initial
 begin
   UpdateResponse                       = 1'b1;
-  txd                                  = 8'h00;
-  txen                                 = 1'b0;
+  txd_n                                = 8'h00;
+  txen_n                               = 1'b0;
+  txer_n                               = 1'b0;
+
+  tx_word                              = 32'h0;
+  tx_ctl                               = 8'h0;
+  tx_shift                             = 24'h0;
+  txc_shift                            = 6'h0;
+  txd_w                                = 8'h00;
+  txen_w                               = 1'b0;
+  txer_w                               = 1'b0;
+  rx_word                              = 32'h0;
+  rxc_word                             = 8'h0;
+  phase                                = 2'd0;
+  vp_clk                               = 1'b0;
 
   count                                = 0;
   halt                                 = 1'b0;
+  trace                                = 1'b0;
 end
 
 // --------------------------------------------
@@ -123,6 +186,47 @@ begin
   count                                <= count + 1;
 end
 
+// --------------------------------------------
+// Wide mode serialiser and deserialiser. Every
+// fourth clock the TX word written by VProc is
+// loaded, and the four received lanes latched
+// for reading.
+// --------------------------------------------
+
+always @(posedge clk)
+begin
+  phase                                <= phase + 2'd1;
+
+  if (phase == 2'd3)
+  begin
+    txd_w                              <= tx_word[7:0];
+    {txer_w, txen_w}                   <= tx_ctl[1:0];
+    tx_shift                           <= tx_word[31:8];
+    txc_shift                          <= tx_ctl[7:2];
+
+    rx_word                            <= {rxd_int, rx_shift};
+    rxc_word                           <= {rxc_int, rxc_shift};
+  end
+  else
+  begin
+    txd_w                              <= tx_shift[7:0];
+    {txer_w, txen_w}                   <= txc_shift[1:0];
+    tx_shift                           <= {8'h00, tx_shift[23:8]};
+    txc_shift                          <= {2'b00, txc_shift[5:2]};
+
+    rx_shift                           <= {rxd_int, rx_shift[23:8]};
+    rxc_shift                          <= {rxc_int, rxc_shift[5:2]};
+  end
+end
+
+// The VProc clock rises on the falling clock edge after the
+// words are transferred, so VProc accesses never coincide
+// with the serialiser's rising edge.
+always @(negedge clk)
+begin
+  vp_clk                               <= (phase == 2'd0);
+end
+
 // --------------------------------------------
 // Asynchronous process to access the ports and
 // internal state.
@@ -142,7 +246,7 @@ begin
       DataIn                           = {24'h0, rxd_int};
       if (WE == 1'b1)
       begin
-        txd                            = DataOut[7:0];
+        txd_n                          = DataOut[7:0];
       end
     end
     // Update the TXC bits, if a write, and read the RXC inputs
@@ -150,8 +254,8 @@ begin
       DataIn                           = {30'h0, rxc_int};
       if (WE == 1'b1)
       begin
-        txen                           = DataOut[0];
-        txer                           = DataOut[1];
+        txen_n                         = DataOut[0];
+        txer_n                         = DataOut[1];
       end
     end
 
@@ -172,6 +276,37 @@ begin
       end
     end
 
+    // Waveform trace enable. Access as a delta update.
+    `TRC_ADDR: begin
+      if (WE == 1'b1)
+      begin
+        trace                          = DataOut[0];
+      end
+    end
+
+    // Number of byte lanes per TX/RX access. Access as a delta update.
+    `LNS_ADDR: begin
+      DataIn                           = lanes;
+    end
+
+    // Wide mode TX data word, if a write, and read the last four RX bytes
+    `WTXD_ADDR: begin
+      DataIn                           = rx_word;
+      if (WE == 1'b1)
+      begin
+        tx_word                        = DataOut;
+      end
+    end
+
+    // Wide mode TX control lanes, if a write, and read the last four RX control lanes
+    `WTXC_ADDR: begin
+      DataIn                           = {24'h0, rxc_word};
+      if (WE == 1'b1)
+      begin
+        tx_ctl                         = DataOut[7:0];
+      end
+    end
+
     // Only the above addresses are valid.
     default: begin
        $display("***ERROR: udp_ip_pg---access to invalid address from VProc");
@@ -190,7 +325,7 @@ end
   // --------------------------------------------
 
   VProc vp (
-   .Clk                                (clk),
+   .Clk                                (vproc_clk),
    .Addr                               (Addr),
    
 `ifdef VPROC_BYTE_ENABLE
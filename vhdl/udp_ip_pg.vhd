@@ -25,9 +25,16 @@ library ieee;
 use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
 
+-- With WIDE set (non-zero), VProc runs at a quarter of the clock rate and
+-- transfers 4 bytes, and 4 control lane pairs, per access on the WTXD and
+-- WTXC registers, which are serialised onto, and deserialised from, GMII.
+-- Byte lane 0 (bits 7:0, controls 1:0) is first on the wire. The LNS
+-- register returns the number of lanes per access (1 when WIDE is clear).
+
 entity udp_ip_pg is
   generic (
-    NODE_NUM                           : integer := 0
+    NODE_NUM                           : integer := 0;
+    WIDE                               : integer := 0
   );
 port (
 
@@ -43,7 +50,10 @@ port (
   rxdv                                 : in  std_logic                    := '0';
   rxer                                 : in  std_logic                    := '0';
 
-  halt                                 : out std_logic                    := '0'
+  halt                                 : out std_logic                    := '0';
+
+  -- Waveform trace enable, for use by the test bench
+  trace                                : out std_logic                    := '0'
 );
 end entity;
 
@@ -53,6 +63,10 @@ architecture behavioural of udp_ip_pg is
   constant TXC_ADDR                    : std_logic_vector(31 downto 0) := 32x"1";
   constant TICKS_ADDR                  : std_logic_vector(31 downto 0) := 32x"2";
   constant HLT_ADDR                    : std_logic_vector(31 downto 0) := 32x"3";
+  constant TRC_ADDR                    : std_logic_vector(31 downto 0) := 32x"4";
+  constant LNS_ADDR                    : std_logic_vector(31 downto 0) := 32x"5";
+  constant WTXD_ADDR                   : std_logic_vector(31 downto 0) := 32x"6";
+  constant WTXC_ADDR                   : std_logic_vector(31 downto 0) := 32x"7";
 
   -- Signals for VProc
   signal update                        : std_logic;
@@ -68,6 +82,27 @@ architecture behavioural of udp_ip_pg is
 
   signal ClkCount                      : integer := 0;
 
+  -- Byte wide mode TX outputs
+  signal txd_n                         : std_logic_vector( 7 downto 0) := 8x"00";
+  signal txen_n                        : std_logic := '0';
+  signal txer_n                        : std_logic := '0';
+
+  -- Wide mode TX and RX words, serialiser/deserialiser state, and the VProc clock
+  signal tx_word                       : std_logic_vector(31 downto 0) := (others => '0');
+  signal tx_ctl                        : std_logic_vector( 7 downto 0) := (others => '0');
+  signal tx_shift                      : std_logic_vector(23 downto 0) := (others => '0');
+  signal txc_shift                     : std_logic_vector( 5 downto 0) := (others => '0');
+  signal txd_w                         : std_logic_vector( 7 downto 0) := 8x"00";
+  signal txen_w                        : std_logic := '0';
+  signal txer_w                        : std_logic := '0';
+  signal rx_shift                      : std_logic_vector(23 downto 0) := (others => '0');
+  signal rxc_shift                     : std_logic_vector( 5 downto 0) := (others => '0');
+  signal rx_word                       : std_logic_vector(31 downto 0) := (others => '0');
+  signal rxc_word                      : std_logic_vector( 7 downto 0) := (others => '0');
+  signal phase                         : unsigned(1 downto 0) := "00";
+  signal vp_clk                        : std_logic := '0';
+  signal vproc_clk                     : std_logic;
+
 begin
 
   -----------------------------------------
@@ -79,6 +114,12 @@ begin
   rxd_int                              <=  rxd         after 1 ns;
   rxc_int                              <=  rxer & rxdv after 1 ns;
 
+  -- Select the TX outputs, and VProc clock, for the mode
+  txd                                  <= txd_w  when WIDE /= 0 else txd_n;
+  txen                                 <= txen_w when WIDE /= 0 else txen_n;
+  txer                                 <= txer_w when WIDE /= 0 else txer_n;
+  vproc_clk                            <= vp_clk when WIDE /= 0 else clk;
+
   -----------------------------------------
   -- Synchronous process
   -----------------------------------------
@@ -90,6 +131,50 @@ begin
     end if;
   end process;
 
+  -----------------------------------------
+  -- Wide mode serialiser and deserialiser.
+  -- Every fourth clock the TX word written
+  -- by VProc is loaded, and the four
+  -- received lanes latched for reading.
+  -----------------------------------------
+
+  process(clk)
+  begin
+    if clk'event and clk = '1' then
+      phase                            <= phase + 1;
+
+      if phase = 3 then
+        txd_w                          <= tx_word(7 downto 0);
+        txen_w                         <= tx_ctl(0);
+        txer_w                         <= tx_ctl(1);
+        tx_shift                       <= tx_word(31 downto 8);
+        txc_shift                      <= tx_ctl(7 downto 2);
+
+        rx_word                        <= rxd_int & rx_shift;
+        rxc_word                       <= rxc_int & rxc_shift;
+      else
+        txd_w                          <= tx_shift(7 downto 0);
+        txen_w                         <= txc_shift(0);
+        txer_w                         <= txc_shift(1);
+        tx_shift                       <= 8x"00" & tx_shift(23 downto 8);
+        txc_shift                      <= "00" & txc_shift(5 downto 2);
+
+        rx_shift                       <= rxd_int & rx_shift(23 downto 8);
+        rxc_shift                      <= rxc_int & rxc_shift(5 downto 2);
+      end if;
+    end if;
+
+    -- The VProc clock rises on the falling clock edge after the words are
+    -- transferred, so VProc accesses never coincide with the rising edge
+    if clk'event and clk = '0' then
+      if phase = 0 then
+        vp_clk                         <= '1';
+      else
+        vp_clk                         <= '0';
+      end if;
+    end if;
+  end process;
+
   -----------------------------------------
   -- Memory map I/O to VProc address space
   -----------------------------------------
@@ -106,14 +191,14 @@ begin
         when TXD_ADDR =>
           DataIn                       <= 24x"0" & rxd_int;
           if WE = '1' then
-            txd                        <= DataOut(7 downto 0);
+            txd_n                      <= DataOut(7 downto 0);
           end if;
 
         when TXC_ADDR =>
           DataIn                       <= 30x"0" & rxc_int;
           if WE = '1' then
-            txen                       <= DataOut(0);
-            txer                       <= DataOut(1);
+            txen_n                     <= DataOut(0);
+            txer_n                     <= DataOut(1);
           end if;
 
         when TICKS_ADDR =>
@@ -124,6 +209,30 @@ begin
             halt                       <= DataOut(0);
           end if;
 
+        when TRC_ADDR =>
+          if WE = '1' then
+            trace                      <= DataOut(0);
+          end if;
+
+        when LNS_ADDR =>
+          if WIDE /= 0 then
+            DataIn                     <= 32x"4";
+          else
+            DataIn                     <= 32x"1";
+          end if;
+
+        when WTXD_ADDR =>
+          DataIn                       <= rx_word;
+          if WE = '1' then
+            tx_word                    <= DataOut;
+          end if;
+
+        when WTXC_ADDR =>
+          DataIn                       <= 24x"0" & rxc_word;
+          if WE = '1' then
+            tx_ctl                     <= DataOut(7 downto 0);
+          end if;
+
         when others =>
             report "***Error. udp_ip_pg---access to invalid address from VProc" severity error;
 
@@ -142,7 +251,7 @@ begin
 
   vproc_inst : entity work.VProc
   port map (
-    Clk                                => clk,
+    Clk                                => vproc_clk,
     Addr                               => Addr,
     WE                                 => WE,
     RD                                 => RD,